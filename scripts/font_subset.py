@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""Generate subsetted LVGL fonts with only the glyphs the UI can show.
+
+Scans the given sources for text passed to LVGL labels (lv_label_set_text*,
+set_numeric_text) and keeps the literal characters of those strings; printf
+conversions are dropped, and the characters they can produce are added with
+--always (digits and the like). The glyph set is then handed to lv_font_conv
+(npm i -g lv_font_conv) once per requested variant:
+
+    4      4 bpp, uncompressed   (same format as the built-in fonts)
+    4rle   4 bpp, LVGL RLE compression (needs CONFIG_LV_USE_FONT_COMPRESSED)
+    2      2 bpp, uncompressed
+
+Besides one app_font_<variant>.c per variant it writes font_variants.c with
+a table of the variants and their glyph bitmap sizes (used by 'perf font'),
+and the app_font_subset pointer to the variant selected with --default.
+
+Example:
+    scripts/font_subset.py --font Montserrat-Medium.ttf --size 14 \\
+        --out-dir build/fonts --variants 4 4rle 2 --default 4 src/*.cpp ui/screens/*.c
+"""
+
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+
+VARIANTS = {
+    "4": ("4bpp", ["--bpp", "4", "--no-compress", "--no-prefilter"]),
+    "4rle": ("4bpp_rle", ["--bpp", "4"]),
+    "2": ("2bpp", ["--bpp", "2", "--no-compress", "--no-prefilter"]),
+}
+
+CALL_RE = re.compile(r"\b(?:lv_label_set_text(?:_static|_fmt)?|set_numeric_text)\s*\(([^;]*?)\)\s*;",
+                     re.S)
+STRING_RE = re.compile(r'"((?:[^"\\]|\\.)*)"')
+PRINTF_RE = re.compile(r"%[-+ #0]*\d*(?:\.\d+)?(?:hh|h|ll|l|z)?[diouxXcsfeEgGp%]")
+
+
+def label_strings(path):
+    with open(path, encoding="utf-8", errors="replace") as src:
+        text = src.read()
+    for call in CALL_RE.finditer(text):
+        for literal in STRING_RE.finditer(call.group(1)):
+            yield bytes(literal.group(1), "utf-8").decode("unicode_escape")
+
+
+def collect_glyphs(sources, always):
+    glyphs = set(always)
+    for path in sources:
+        for literal in label_strings(path):
+            literal = PRINTF_RE.sub(lambda m: "%" if m.group(0) == "%%" else "", literal)
+            glyphs.update(ch for ch in literal if ch.isprintable())
+    glyphs.discard("")
+    return "".join(sorted(glyphs))
+
+
+def bitmap_bytes(c_file):
+    """Counts the bytes of glyph_bitmap[] in an lv_font_conv output file."""
+    with open(c_file, encoding="utf-8") as src:
+        text = src.read()
+    start = text.find("glyph_bitmap[] = {")
+    end = text.find("};", start)
+    if start < 0 or end < 0:
+        return 0
+    return len(re.findall(r"0x[0-9a-fA-F]+", text[start:end]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("sources", nargs="+", help="files to scan for label text")
+    parser.add_argument("--font", required=True, help="TTF/WOFF source font")
+    parser.add_argument("--size", type=int, default=14)
+    parser.add_argument("--out-dir", required=True)
+    parser.add_argument("--variants", nargs="+", default=["4"], choices=sorted(VARIANTS))
+    parser.add_argument("--default", default="4", choices=sorted(VARIANTS),
+                        help="variant exported as app_font_subset")
+    parser.add_argument("--always", default="0123456789:%-. ",
+                        help="glyphs always included (printf output)")
+    parser.add_argument("--lv-font-conv", default=shutil.which("lv_font_conv") or "lv_font_conv")
+    args = parser.parse_args()
+
+    if args.default not in args.variants:
+        args.variants.append(args.default)
+
+    glyphs = collect_glyphs(args.sources, args.always)
+    os.makedirs(args.out_dir, exist_ok=True)
+    print(f"font_subset: {len(glyphs)} glyphs: {glyphs!r}")
+
+    table = []
+    for variant in args.variants:
+        suffix, flags = VARIANTS[variant]
+        name = f"app_font_{suffix}"
+        out = os.path.join(args.out_dir, f"{name}.c")
+        cmd = [args.lv_font_conv, "--font", args.font, "--size", str(args.size),
+               "--symbols", glyphs, "--format", "lvgl", "--lv-include", "lvgl.h",
+               "--lv-font-name", name, "-o", out] + flags
+        try:
+            subprocess.run(cmd, check=True)
+        except FileNotFoundError:
+            sys.exit(f"font_subset: {args.lv_font_conv} not found (npm i -g lv_font_conv)")
+        size = bitmap_bytes(out)
+        table.append((suffix, name, size))
+        print(f"font_subset: {name}: {size} bitmap bytes")
+
+    default_name = f"app_font_{VARIANTS[args.default][0]}"
+    with open(os.path.join(args.out_dir, "font_variants.c"), "w", encoding="utf-8") as out:
+        out.write("/* Generated by scripts/font_subset.py, do not edit. */\n")
+        out.write('#include "font_subset.h"\n\n')
+        for _, name, _ in table:
+            out.write(f"LV_FONT_DECLARE({name})\n")
+        out.write("\nconst struct app_font_variant app_font_variants[] = {\n")
+        for suffix, name, size in table:
+            out.write(f'\t{{"{suffix}", &{name}, {size}U}},\n')
+        out.write("};\n\n")
+        out.write(f"const size_t app_font_variant_count = {len(table)};\n")
+        escaped = glyphs.replace("\\", "\\\\").replace('"', '\\"')
+        out.write(f'const char app_font_glyphs[] = "{escaped}";\n')
+        out.write(f"const lv_font_t *const app_font_subset = &{default_name};\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+"""Decode the flash metrics journal written by src/journal.cpp.
+
+Capture the output of 'journal dump' from the shell (terminal log, or
+--port to read it straight from the serial console) and decode it into
+one CSV row per record. Blocks are self-contained: the first record of a
+block is absolute, the rest are deltas, all LEB128 varints.
+
+Example:
+    scripts/journal_decode.py dump.txt > history.csv
+    scripts/journal_decode.py --port /dev/ttyACM0
+"""
+
+import argparse
+import datetime
+import struct
+import sys
+
+BLOCK_MAGIC = 0x424A
+BLOCK_HEADER = struct.Struct("<HHI")
+FIELDS = ("uptime_s", "rtc_epoch", "load_permille", "heap_used", "min_stack", "fps")
+
+
+def read_varint(data, pos):
+    value = 0
+    shift = 0
+    while True:
+        if pos >= len(data):
+            raise ValueError("truncated varint")
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, pos
+
+
+def unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def decode_block(data):
+    magic, length, boot = BLOCK_HEADER.unpack_from(data)
+    if magic != BLOCK_MAGIC:
+        raise ValueError(f"bad block magic {magic:#x}")
+    payload = data[BLOCK_HEADER.size:BLOCK_HEADER.size + length]
+    prev = [0] * len(FIELDS)
+    pos = 0
+    while pos < len(payload):
+        rec = []
+        for i in range(len(FIELDS)):
+            raw, pos = read_varint(payload, pos)
+            rec.append(prev[i] + (raw if i == 0 else unzigzag(raw)))
+        prev = rec
+        yield boot, rec
+
+
+def parse_dump(lines):
+    """Yields (offset, bytes) for every block in a 'journal dump' capture."""
+    offset = None
+    chunks = []
+    for line in lines:
+        line = line.strip()
+        if line.startswith("B "):
+            if offset is not None:
+                yield offset, bytes.fromhex("".join(chunks))
+            offset = int(line[2:], 16)
+            chunks = []
+        elif line.startswith("D ") and offset is not None:
+            chunks.append(line[2:])
+        elif line == "J end":
+            break
+    if offset is not None:
+        yield offset, bytes.fromhex("".join(chunks))
+
+
+def serial_lines(port, baud):
+    import serial  # pyserial, only needed for --port
+
+    with serial.Serial(port, baud, timeout=5) as ser:
+        ser.write(b"journal dump\r\n")
+        while True:
+            line = ser.readline()
+            if not line:
+                return
+            text = line.decode(errors="replace")
+            yield text
+            if text.strip() == "J end":
+                return
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("dump", nargs="?", help="captured 'journal dump' output (default: stdin)")
+    parser.add_argument("--port", help="read the dump from this serial console instead")
+    parser.add_argument("--baud", type=int, default=115200)
+    args = parser.parse_args()
+
+    if args.port:
+        lines = serial_lines(args.port, args.baud)
+    elif args.dump:
+        lines = open(args.dump, encoding="utf-8", errors="replace")
+    else:
+        lines = sys.stdin
+
+    print("boot,rtc_time," + ",".join(FIELDS))
+    for offset, data in parse_dump(lines):
+        try:
+            for boot, rec in decode_block(data):
+                epoch = rec[1]
+                when = (datetime.datetime.fromtimestamp(epoch, datetime.timezone.utc).isoformat()
+                        if epoch > 0 else "")
+                print(f"{boot},{when}," + ",".join(str(v) for v in rec))
+        except ValueError as err:
+            print(f"block @{offset:#x}: {err}", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
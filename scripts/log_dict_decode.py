@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+"""Decode dictionary-based log output of this app on the host.
+
+The dictionary database is regenerated from the build's zephyr.elf every
+run, so the decoder always matches the firmware that is actually flashed.
+Decoding itself is delegated to Zephyr's scripts/logging/dictionary tools.
+
+Examples:
+    scripts/log_dict_decode.py -d build --serial /dev/ttyUSB0
+    scripts/log_dict_decode.py -d build --file capture.bin
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+
+
+def zephyr_base():
+    base = os.environ.get("ZEPHYR_BASE")
+    if not base:
+        sys.exit("ZEPHYR_BASE is not set (source zephyr-env.sh or use west)")
+    return base
+
+
+def generate_database(base, build_dir):
+    elf = os.path.join(build_dir, "zephyr", "zephyr.elf")
+    if not os.path.isfile(elf):
+        sys.exit(f"{elf} not found, build the firmware first")
+
+    db = os.path.join(build_dir, "zephyr", "log_dictionary.json")
+    cmd = [sys.executable,
+           os.path.join(base, "scripts", "logging", "dictionary", "database_gen.py")]
+    header = os.path.join(build_dir, "zephyr", "include", "generated", "zephyr",
+                          "version.h")
+    if os.path.isfile(header):
+        cmd += ["--build-header", header]
+    cmd += [elf, db]
+    subprocess.run(cmd, check=True)
+    return db
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("-d", "--build-dir", default="build",
+                        help="west build directory (default: build)")
+    src = parser.add_mutually_exclusive_group(required=True)
+    src.add_argument("--serial", help="serial port connected to the log UART")
+    src.add_argument("--file", help="previously captured binary log")
+    parser.add_argument("--baud", type=int, default=921600,
+                        help="log UART baudrate (default: 921600, see log_dict.overlay)")
+    args = parser.parse_args()
+
+    base = zephyr_base()
+    db = generate_database(base, args.build_dir)
+    tools = os.path.join(base, "scripts", "logging", "dictionary")
+
+    if args.serial:
+        cmd = [sys.executable, os.path.join(tools, "log_parser_uart.py"),
+               db, args.serial, str(args.baud)]
+    else:
+        cmd = [sys.executable, os.path.join(tools, "log_parser.py"), db, args.file]
+
+    try:
+        return subprocess.run(cmd).returncode
+    except KeyboardInterrupt:
+        return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
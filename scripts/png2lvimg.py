@@ -0,0 +1,233 @@
+#!/usr/bin/env python3
+"""Convert PNG assets into compiled-in LVGL 9 image descriptors.
+
+SquareLine exports images as "S:assets/foo.png" paths, which need an LVGL
+filesystem driver and a PNG decoder at runtime. This script decodes the
+PNGs on the build host (pure Python, no Pillow) and writes one C file per
+asset with a const lv_image_dsc_t in flash, named like the SLS symbol
+(ui_img_<name>_png), plus ui_img_assets.h declaring them all.
+
+The colour format is picked per asset:
+
+    A8        one colour with varying alpha (knobs, lines): only the alpha
+              is stored, the colour is applied with image_recolor
+              (UI_IMG_<NAME>_COLOR in the header)
+    I1/I2/I4  few distinct colours: palette + packed indices
+    RGB565    opaque
+    RGB565A8  RGB565 plane followed by an A8 plane
+
+Pixels are stored in LVGL's native little-endian RGB565. The display flush
+already swaps bytes for the panel, so pre-swapped assets would come out
+wrong once blended.
+
+Example:
+    scripts/png2lvimg.py --out-dir build/ui_images ui/drive/assets/*.png
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+import zlib
+
+PNG_SIGNATURE = b"\x89PNG\r\n\x1a\n"
+CHANNELS = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}
+
+
+def paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+
+def read_png(path):
+    """Returns (width, height, rows of RGBA tuples). 8-bit, non-interlaced only."""
+    with open(path, "rb") as src:
+        data = src.read()
+    if not data.startswith(PNG_SIGNATURE):
+        raise ValueError("not a PNG file")
+    pos = len(PNG_SIGNATURE)
+    idat = b""
+    palette = []
+    trns = b""
+    while pos < len(data):
+        length, kind = struct.unpack_from(">I4s", data, pos)
+        body = data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if kind == b"IHDR":
+            width, height, depth, ctype, _, _, interlace = struct.unpack(">IIBBBBB", body)
+        elif kind == b"PLTE":
+            palette = [tuple(body[i:i + 3]) for i in range(0, len(body), 3)]
+        elif kind == b"tRNS":
+            trns = body
+        elif kind == b"IDAT":
+            idat += body
+        elif kind == b"IEND":
+            break
+    if depth != 8 or interlace != 0 or ctype not in CHANNELS:
+        raise ValueError(f"unsupported PNG (depth {depth}, type {ctype}, interlace {interlace})")
+
+    bpp = CHANNELS[ctype]
+    stride = width * bpp
+    raw = zlib.decompress(idat)
+    prev = bytearray(stride)
+    rows = []
+    for y in range(height):
+        base = y * (stride + 1)
+        ftype = raw[base]
+        line = bytearray(raw[base + 1:base + 1 + stride])
+        for i in range(stride):
+            left = line[i - bpp] if i >= bpp else 0
+            up = prev[i]
+            upleft = prev[i - bpp] if i >= bpp else 0
+            if ftype == 1:
+                line[i] = (line[i] + left) & 0xFF
+            elif ftype == 2:
+                line[i] = (line[i] + up) & 0xFF
+            elif ftype == 3:
+                line[i] = (line[i] + ((left + up) >> 1)) & 0xFF
+            elif ftype == 4:
+                line[i] = (line[i] + paeth(left, up, upleft)) & 0xFF
+        prev = line
+        row = []
+        for x in range(width):
+            px = line[x * bpp:(x + 1) * bpp]
+            if ctype == 6:
+                row.append(tuple(px))
+            elif ctype == 2:
+                row.append((px[0], px[1], px[2], 255))
+            elif ctype == 4:
+                row.append((px[0], px[0], px[0], px[1]))
+            elif ctype == 0:
+                row.append((px[0], px[0], px[0], 255))
+            else:
+                r, g, b = palette[px[0]]
+                row.append((r, g, b, trns[px[0]] if px[0] < len(trns) else 255))
+        rows.append(row)
+    return width, height, rows
+
+
+def rgb565(r, g, b):
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+
+
+def single_colour(pixels, tolerance=12):
+    """The common colour of all visible pixels, or None."""
+    visible = [p for p in pixels if p[3] > 0]
+    if not visible:
+        return (0, 0, 0)
+    weight = sum(p[3] for p in visible)
+    mean = tuple(sum(p[c] * p[3] for p in visible) // weight for c in range(3))
+    for p in visible:
+        if p[3] > 32 and max(abs(p[c] - mean[c]) for c in range(3)) > tolerance:
+            return None
+    return mean
+
+
+def encode(width, height, rows):
+    """Returns (cf, stride, bytes, colour or None)."""
+    pixels = [p for row in rows for p in row]
+    opaque = all(p[3] == 255 for p in pixels)
+
+    colour = None if opaque else single_colour(pixels)
+    if colour is not None:
+        return "A8", width, bytes(p[3] for p in pixels), colour
+
+    distinct = sorted(set(pixels))
+    for bits in (1, 2, 4):
+        if len(distinct) > (1 << bits):
+            continue
+        index = {p: i for i, p in enumerate(distinct)}
+        out = bytearray()
+        for i in range(1 << bits):
+            r, g, b, a = distinct[i] if i < len(distinct) else (0, 0, 0, 0)
+            out += bytes((b, g, r, a))  # lv_color32_t order
+        per_byte = 8 // bits
+        stride = (width + per_byte - 1) // per_byte
+        for row in rows:
+            line = bytearray(stride)
+            for x, p in enumerate(row):
+                shift = 8 - bits * (x % per_byte + 1)
+                line[x // per_byte] |= index[p] << shift
+            out += line
+        return f"I{bits}", stride, bytes(out), None
+
+    plane = bytearray()
+    for p in pixels:
+        plane += struct.pack("<H", rgb565(p[0], p[1], p[2]))
+    if opaque:
+        return "RGB565", width * 2, bytes(plane), None
+    return "RGB565A8", width * 2, bytes(plane) + bytes(p[3] for p in pixels), None
+
+
+def c_array(data):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append("\t" + ", ".join(f"0x{b:02x}" for b in data[i:i + 16]) + ",")
+    return "\n".join(lines)
+
+
+def symbol_for(path):
+    base = os.path.splitext(os.path.basename(path))[0]
+    return "ui_img_" + re.sub(r"[^0-9a-zA-Z_]", "_", base).lower() + "_png"
+
+
+def write_asset(out_dir, path):
+    width, height, rows = read_png(path)
+    cf, stride, data, colour = encode(width, height, rows)
+    sym = symbol_for(path)
+    with open(os.path.join(out_dir, f"{sym}.c"), "w", encoding="utf-8") as out:
+        out.write(f"/* Generated by scripts/png2lvimg.py from {os.path.basename(path)}, do not edit. */\n")
+        out.write('#include "ui_img_assets.h"\n\n')
+        out.write("#ifndef LV_ATTRIBUTE_MEM_ALIGN\n#define LV_ATTRIBUTE_MEM_ALIGN\n#endif\n")
+        out.write("#ifndef LV_ATTRIBUTE_LARGE_CONST\n#define LV_ATTRIBUTE_LARGE_CONST\n#endif\n\n")
+        out.write(f"static LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST const uint8_t {sym}_map[] = {{\n")
+        out.write(c_array(data) + "\n};\n\n")
+        out.write(f"const lv_image_dsc_t {sym} = {{\n")
+        out.write("\t.header.magic = LV_IMAGE_HEADER_MAGIC,\n")
+        out.write(f"\t.header.cf = LV_COLOR_FORMAT_{cf},\n")
+        out.write(f"\t.header.w = {width},\n\t.header.h = {height},\n")
+        out.write(f"\t.header.stride = {stride},\n")
+        out.write(f"\t.data_size = sizeof({sym}_map),\n")
+        out.write(f"\t.data = {sym}_map,\n}};\n")
+    return sym, cf, width, height, len(data), colour
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("pngs", nargs="+")
+    parser.add_argument("--out-dir", required=True)
+    args = parser.parse_args()
+
+    os.makedirs(args.out_dir, exist_ok=True)
+    assets = []
+    for path in sorted(args.pngs):
+        try:
+            assets.append(write_asset(args.out_dir, path))
+        except (OSError, ValueError, zlib.error) as err:
+            sys.exit(f"png2lvimg: {path}: {err}")
+
+    total = sum(a[4] for a in assets)
+    with open(os.path.join(args.out_dir, "ui_img_assets.h"), "w", encoding="utf-8") as out:
+        out.write("/* Generated by scripts/png2lvimg.py, do not edit. */\n")
+        out.write("#pragma once\n\n#include <lvgl.h>\n\n")
+        out.write("#ifdef __cplusplus\nextern \"C\" {\n#endif\n\n")
+        out.write(f"/* Flash cost: {total} bytes of pixel data in {len(assets)} images. */\n\n")
+        for sym, cf, width, height, size, colour in assets:
+            out.write(f"/* {width}x{height} {cf}, {size} bytes */\n")
+            out.write(f"LV_IMAGE_DECLARE({sym});\n")
+            if colour is not None:
+                out.write(f"#define {sym.upper()}_COLOR 0x{colour[0]:02x}{colour[1]:02x}{colour[2]:02x}\n")
+        out.write("\n#ifdef __cplusplus\n}\n#endif\n")
+
+    for sym, cf, width, height, size, _ in assets:
+        print(f"png2lvimg: {sym:<34} {width:>4}x{height:<4} {cf:<9} {size:>7} B")
+    print(f"png2lvimg: total {total} B in {len(assets)} images")
+
+
+if __name__ == "__main__":
+    main()
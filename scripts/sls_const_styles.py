@@ -0,0 +1,196 @@
+#!/usr/bin/env python3
+"""Turn SquareLine's local style calls into shared const styles.
+
+SquareLine exports every style property as a local style call:
+
+    lv_obj_set_style_arc_color(ui_Arc1, lv_color_hex(0xAFFF00), LV_PART_INDICATOR | LV_STATE_DEFAULT);
+
+Each object/selector pair with local styles costs an lv_style_t plus a
+values/props array from the LVGL pool, allocated at screen init and grown
+one realloc per property. This script runs on the exported sources at build
+time and writes transformed copies: the calls for one object and selector
+are replaced by a single lv_obj_add_style() of an LV_STYLE_CONST_INIT style
+in flash, and pairs with the same property set share one style.
+
+Only properties whose value is a compile-time constant are moved
+(integer literals, macro/enum names, &symbol, lv_color_hex(0x...),
+lv_pct(n)); anything else stays a local style call. Style calls are only
+grouped within one function, so event handlers keep their runtime order.
+
+The exported files in ui/ are not modified, so re-exporting from SquareLine
+Studio keeps working; the copies are regenerated on the next build.
+
+Example:
+    scripts/sls_const_styles.py --src-root ui --out-dir build/ui_const ui/screens/ui_Screen1.c
+"""
+
+import argparse
+import os
+import re
+import sys
+
+STYLE_CALL = re.compile(r"^(\s*)lv_obj_set_style_(\w+)\((.*)\)\s*;\s*(//.*)?$")
+INCLUDE_UP = re.compile(r'^(\s*#\s*include\s+")(\.\./)+')
+CONST_VALUE = re.compile(r"^(-?(0x[0-9a-fA-F]+|\d+)|[A-Z_][A-Z0-9_]*|&\w+)$")
+COLOR_HEX = re.compile(r"^lv_color_hex\(\s*0x([0-9a-fA-F]{6})\s*\)$")
+PCT = re.compile(r"^lv_pct\(\s*(-?\d+)\s*\)$")
+
+# Pool cost of one local style on 32-bit LVGL 9: lv_style_t (12 B) and the
+# values/props array (4 B value + 1 B prop id per property), each a separate
+# TLSF block with an 8 B header. The lv_obj_style_t slot in obj->styles is
+# needed by lv_obj_add_style() too, so it is not counted.
+STYLE_T_BYTES = 12
+BLOCK_HEADER_BYTES = 8
+VALUE_BYTES = 4
+PROP_ID_BYTES = 1
+
+
+def split_args(text):
+    """Split a call's argument list on top-level commas."""
+    args, depth, cur = [], 0, ""
+    for ch in text:
+        if ch == "," and depth == 0:
+            args.append(cur.strip())
+            cur = ""
+            continue
+        if ch in "([":
+            depth += 1
+        elif ch in ")]":
+            depth -= 1
+        cur += ch
+    args.append(cur.strip())
+    return args
+
+
+def const_value(value):
+    """The value as a constant initializer, or None if it must stay local."""
+    m = COLOR_HEX.match(value)
+    if m:
+        rgb = m.group(1)
+        return f"LV_COLOR_MAKE(0x{rgb[0:2]}, 0x{rgb[2:4]}, 0x{rgb[4:6]})"
+    m = PCT.match(value)
+    if m:
+        return f"LV_PCT({m.group(1)})"
+    if CONST_VALUE.match(value):
+        return value
+    return None
+
+
+def local_bytes(prop_cnt):
+    array = prop_cnt * (VALUE_BYTES + PROP_ID_BYTES)
+    array = (array + 3) & ~3
+    return STYLE_T_BYTES + array + 2 * BLOCK_HEADER_BYTES
+
+
+def transform(lines, prefix):
+    """Returns (new lines, style definitions, stats dict)."""
+    # Pass 1: collect constant style calls per (function, object, selector).
+    groups = {}
+    order = []
+    func = 0
+    depth = 0
+    for i, line in enumerate(lines):
+        if depth == 0 and line.strip() == "{":
+            func += 1
+        m = STYLE_CALL.match(line)
+        if m and depth > 0:
+            args = split_args(m.group(3))
+            if len(args) == 3:
+                obj, value, selector = args
+                cvalue = const_value(value)
+                if cvalue is not None:
+                    key = (func, obj, re.sub(r"\s+", "", selector))
+                    if key not in groups:
+                        groups[key] = {"lines": [], "props": {}, "selector": selector}
+                        order.append(key)
+                    groups[key]["lines"].append(i)
+                    groups[key]["props"][m.group(2)] = cvalue
+        depth += line.count("{") - line.count("}")
+
+    # Pass 2: one const style per distinct property set.
+    styles = {}
+    defs = []
+    replace = {}
+    drop = set()
+    for key in order:
+        group = groups[key]
+        props = tuple(sorted(group["props"].items()))
+        if props not in styles:
+            name = f"{prefix}_{len(styles)}"
+            styles[props] = name
+            defs.append(f"static const lv_style_const_prop_t {name}_props[] = {{")
+            for prop, value in props:
+                defs.append(f"\tLV_STYLE_CONST_{prop.upper()}({value}),")
+            defs.append("\tLV_STYLE_CONST_PROPS_END")
+            defs.append("};")
+            defs.append(f"static LV_STYLE_CONST_INIT({name}, {name}_props);")
+            defs.append("")
+        first = group["lines"][0]
+        indent = STYLE_CALL.match(lines[first]).group(1)
+        replace[first] = (f"{indent}lv_obj_add_style({key[1]}, &{styles[props]}, "
+                          f"{group['selector']});    /// const style\n")
+        drop.update(group["lines"][1:])
+
+    out = []
+    for i, line in enumerate(lines):
+        if i in drop:
+            continue
+        line = replace.get(i, line)
+        out.append(INCLUDE_UP.sub(r"\1", line))
+
+    stats = {
+        "calls": sum(len(g["lines"]) for g in groups.values()),
+        "groups": len(groups),
+        "styles": len(styles),
+        "pool_bytes": sum(local_bytes(len(g["props"])) for g in groups.values()),
+    }
+    return out, defs, stats
+
+
+def insert_defs(lines, defs):
+    if not defs:
+        return lines
+    last_include = max((i for i, l in enumerate(lines) if l.lstrip().startswith("#include")),
+                       default=-1)
+    block = ["\n", "/* Const styles generated by scripts/sls_const_styles.py */\n"]
+    block += [d + "\n" for d in defs]
+    return lines[:last_include + 1] + block + lines[last_include + 1:]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("sources", nargs="+")
+    parser.add_argument("--src-root", required=True)
+    parser.add_argument("--out-dir", required=True)
+    args = parser.parse_args()
+
+    total = {"calls": 0, "groups": 0, "styles": 0, "pool_bytes": 0}
+    for path in args.sources:
+        rel = os.path.relpath(path, args.src_root)
+        prefix = "ui_cstyle_" + re.sub(r"[^0-9a-zA-Z_]", "_", os.path.splitext(os.path.basename(rel))[0])
+        try:
+            with open(path, encoding="utf-8") as src:
+                lines = src.readlines()
+        except OSError as err:
+            sys.exit(f"sls_const_styles: {path}: {err}")
+
+        out, defs, stats = transform(lines, prefix)
+        dest = os.path.join(args.out_dir, rel)
+        os.makedirs(os.path.dirname(dest), exist_ok=True)
+        with open(dest, "w", encoding="utf-8") as dst:
+            dst.write(f"/* Generated by scripts/sls_const_styles.py from {rel}, do not edit. */\n")
+            dst.writelines(insert_defs(out, defs))
+
+        for k in total:
+            total[k] += stats[k]
+        print(f"sls_const_styles: {rel}: {stats['calls']} local style calls on "
+              f"{stats['groups']} object/selector pairs -> {stats['styles']} const styles, "
+              f"~{stats['pool_bytes']} B LVGL pool")
+    if len(args.sources) > 1:
+        print(f"sls_const_styles: total {total['calls']} calls -> {total['styles']} const styles, "
+              f"~{total['pool_bytes']} B LVGL pool")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+"""Receive and print UDP telemetry datagrams sent by src/telemetry.cpp.
+
+Works against the board (Ethernet) and native_sim (offloaded sockets, peer
+127.0.0.1). Prints one line per datagram, or a per-second summary with
+--summary, which is handier at 100 Hz.
+
+Example:
+    scripts/telemetry_rx.py --port 4950 --summary
+"""
+
+import argparse
+import socket
+import struct
+import sys
+import time
+
+MAGIC = 0x4D54
+HEADER = struct.Struct("<HBBIIHHIIIII")
+THREAD = struct.Struct("<8sbBHH")
+
+
+def decode(data):
+    if len(data) < HEADER.size:
+        raise ValueError("short datagram")
+    (magic, version, count, seq, uptime_ms, load, fps, heap_used, heap_free,
+     heap_peak, min_stack, log_dropped) = HEADER.unpack_from(data)
+    if magic != MAGIC or version != 1:
+        raise ValueError(f"bad magic/version {magic:#x}/{version}")
+    threads = []
+    for i in range(count):
+        name, prio, _, t_load, stack_free = THREAD.unpack_from(
+            data, HEADER.size + i * THREAD.size)
+        threads.append((name.rstrip(b"\0").decode(errors="replace"), prio,
+                        t_load, stack_free))
+    return {
+        "seq": seq, "uptime_ms": uptime_ms, "load": load, "fps": fps,
+        "heap_used": heap_used, "heap_free": heap_free, "heap_peak": heap_peak,
+        "min_stack": min_stack, "log_dropped": log_dropped, "threads": threads,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--bind", default="0.0.0.0")
+    parser.add_argument("--port", type=int, default=4950)
+    parser.add_argument("--summary", action="store_true",
+                        help="print rate/loss once per second instead of every datagram")
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind((args.bind, args.port))
+
+    last_seq = None
+    lost = 0
+    received = 0
+    window_start = time.monotonic()
+
+    while True:
+        data, peer = sock.recvfrom(2048)
+        try:
+            pkt = decode(data)
+        except ValueError as err:
+            print(f"{peer[0]}: {err}", file=sys.stderr)
+            continue
+
+        if last_seq is not None and pkt["seq"] > last_seq + 1:
+            lost += pkt["seq"] - last_seq - 1
+        last_seq = pkt["seq"]
+        received += 1
+
+        if not args.summary:
+            threads = " ".join(f"{n}:{l / 10:.1f}%/{s}B" for n, _, l, s in pkt["threads"])
+            print(f"{peer[0]} #{pkt['seq']} up={pkt['uptime_ms'] / 1000:.2f}s "
+                  f"cpu={pkt['load'] / 10:.1f}% fps={pkt['fps']} "
+                  f"heap={pkt['heap_used']}/{pkt['heap_used'] + pkt['heap_free']}B "
+                  f"peak={pkt['heap_peak']}B min_stack={pkt['min_stack']}B "
+                  f"log_drop={pkt['log_dropped']} | {threads}")
+            continue
+
+        now = time.monotonic()
+        if now - window_start >= 1.0:
+            rate = received / (now - window_start)
+            print(f"{peer[0]} {rate:.1f} pkt/s lost={lost} cpu={pkt['load'] / 10:.1f}% "
+                  f"fps={pkt['fps']} heap={pkt['heap_used']}B log_drop={pkt['log_dropped']}")
+            received = 0
+            window_start = now
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
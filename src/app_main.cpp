@@ -5,17 +5,22 @@
 #include "app_cpp.h"
 #include "cpp_examples.hpp"
 #include "fpu_demo.hpp"
+#include "journal.hpp"
 #include "lvgl_demo.hpp"
+#include "metrics_http.hpp"
 #include "msgq_demo.hpp"
+#include "oled_demo.hpp"
 #include "rtc_service.hpp"
+#include "telemetry.hpp"
  
 #define STATUS_PERIOD_MS 500
-#define LVGL_PERIOD_MS 16
 #define LED0_BLINK_MS 100
 #define LED1_BLINK_MS 250
 #define LED2_BLINK_MS 500
 #define LED_STACK_SIZE 512
 #define LED_THREAD_PRIO 9
+#define OLED_DEMO_STACK_SIZE 1024
+#define OLED_DEMO_PRIO 7
  
 static const gpio_dt_spec led0 = GPIO_DT_SPEC_GET(DT_ALIAS(led0), gpios);
 #if DT_NODE_EXISTS(DT_ALIAS(led1))
@@ -44,8 +49,34 @@ static struct k_thread led2_thread;
 static struct led_ctx led2_ctx = { .led = &led2, .period_ms = LED2_BLINK_MS };
 #endif
  
+#if defined(CONFIG_APP_OLED_DEMO)
+K_THREAD_STACK_DEFINE(oled_demo_stack, OLED_DEMO_STACK_SIZE);
+static struct k_thread oled_demo_thread;
+#endif
+ 
 LOG_MODULE_REGISTER(app, LOG_LEVEL_INF);
  
+static struct k_work_delayable status_work;
+static int64_t status_deadline_ms;
+static uint32_t status_ticks;
+ 
+/* Runs on the system workqueue at absolute uptime deadlines, so the period
+ * doesn't drift with handler run time. Missed periods are skipped.
+ */
+static void status_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+ 
+	cpp_examples_tick(++status_ticks);
+ 
+	int64_t now = k_uptime_get();
+ 
+	do {
+		status_deadline_ms += STATUS_PERIOD_MS;
+	} while (status_deadline_ms <= now);
+	(void)k_work_schedule(&status_work, K_TIMEOUT_ABS_MS(status_deadline_ms));
+}
+ 
 static void led_worker(void *p1, void *p2, void *p3)
 {
 	auto *ctx = static_cast<const struct led_ctx *>(p1);
@@ -76,18 +107,46 @@ static void start_led_blinker(struct led_ctx *ctx, struct k_thread *thread, k_th
 	k_thread_name_set(thread, name);
 }
  
-int app_cpp_run(void)
+#if defined(CONFIG_APP_OLED_DEMO)
+/* oled_demo_tick() waits for its strips to reach the panel, so it gets its
+ * own thread rather than a work item on a shared queue.
+ */
+static void oled_demo_worker(void *p1, void *p2, void *p3)
+{
+	uint32_t tick = 0;
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+ 
+	oled_demo_init();
+	while (true) {
+		oled_demo_tick(tick++);
+		k_msleep(CONFIG_APP_OLED_DEMO_TICK_MS);
+	}
+}
+ 
+static void start_oled_demo()
 {
-	uint32_t ticks = 0;
-	uint32_t status_ticks = 0;
+	k_thread_create(&oled_demo_thread, oled_demo_stack, K_THREAD_STACK_SIZEOF(oled_demo_stack),
+			oled_demo_worker, nullptr, nullptr, nullptr, OLED_DEMO_PRIO, 0, K_NO_WAIT);
+	k_thread_name_set(&oled_demo_thread, "oled_demo");
+}
+#endif
  
+int app_cpp_run(void)
+{
 	if (!rtc_service_init()) {
 		return 0;
 	}
  
 	// start_fpu_demo();
 	// start_msgq_demo();
+#if defined(CONFIG_APP_OLED_DEMO)
+	/* One panel: the test patterns replace the LVGL dashboard. */
+	start_oled_demo();
+#else
 	lvgl_demo_init();
+#endif
 	start_led_blinker(&led0_ctx, &led0_thread, led0_stack, K_THREAD_STACK_SIZEOF(led0_stack),
 			  "led0_100ms");
 #if DT_NODE_EXISTS(DT_ALIAS(led1))
@@ -102,17 +161,22 @@ int app_cpp_run(void)
 #else
 	LOG_WRN("led2 alias is missing in devicetree");
 #endif
+#if defined(CONFIG_APP_TELEMETRY_AUTOSTART)
+	(void)telemetry_start();
+#endif
+#if defined(CONFIG_APP_METRICS)
+	(void)metrics_http_start();
+#endif
+#if defined(CONFIG_APP_JOURNAL)
+	(void)journal_start();
+#endif
+
+	/* Everything periodic is work items now (UI updates on the LVGL
+	 * workqueue, see LvglDemo), so the main thread has nothing left to do.
+	 */
+	k_work_init_delayable(&status_work, status_handler);
+	status_deadline_ms = k_uptime_get() + STATUS_PERIOD_MS;
+	(void)k_work_schedule(&status_work, K_TIMEOUT_ABS_MS(status_deadline_ms));
 	LOG_INF("C++ demos started");
- 
-	while (true) {
-		ticks += LVGL_PERIOD_MS;
-		status_ticks += LVGL_PERIOD_MS;
-		lvgl_demo_tick(ticks);
-		if (status_ticks >= STATUS_PERIOD_MS) {
-			status_ticks = 0;
-			cpp_examples_tick(ticks / STATUS_PERIOD_MS);
-		}
- 
-		k_msleep(LVGL_PERIOD_MS);
-	}
+	return 0;
 }
@@ -0,0 +1,74 @@
+#include "color_order.hpp"
+#include <zephyr/sys/util.h>
+#include <stdint.h>
+ 
+/* Panels wired with another channel order (this SSD1351 revision is B-R-G)
+ * need every LVGL pixel remapped. Each output bit of the remap is a copy of
+ * one input bit, so the 64K-entry table splits into one table per input
+ * byte whose results are OR-ed: 1 KB instead of 128 KB. The byte swap for
+ * the SPI transfer order is folded into the same tables, so the remap costs
+ * no extra pass over the buffer compared to the plain swap it replaces.
+ *
+ * The STM32H7 DMA2D can only swap R/B and bytes on output, not rotate
+ * channels, so this is done on the CPU, two pixels per 32-bit word.
+ */
+namespace display {
+static uint16_t lut_hi[256];
+static uint16_t lut_lo[256];
+ 
+static uint16_t remap(uint16_t px)
+{
+	uint32_t r5 = px >> 11;
+	uint32_t g6 = (px >> 5) & 0x3FU;
+	uint32_t b5 = px & 0x1FU;
+	uint32_t out;
+ 
+#if defined(CONFIG_APP_PANEL_COLOR_ORDER_RBG)
+	out = (r5 << 11) | (((b5 << 1) | (b5 >> 4)) << 5) | (g6 >> 1);
+#elif defined(CONFIG_APP_PANEL_COLOR_ORDER_BRG)
+	out = (b5 << 11) | (((r5 << 1) | (r5 >> 4)) << 5) | (g6 >> 1);
+#else
+	out = (r5 << 11) | (g6 << 5) | b5;
+#endif
+#if defined(CONFIG_LV_COLOR_16_SWAP)
+	out = ((out & 0xFFU) << 8) | (out >> 8);
+#endif
+	return static_cast<uint16_t>(out);
+}
+ 
+void color_order_init()
+{
+	for (uint32_t i = 0; i < 256U; ++i) {
+		lut_hi[i] = remap(static_cast<uint16_t>(i << 8));
+		lut_lo[i] = remap(static_cast<uint16_t>(i));
+	}
+}
+ 
+static inline uint32_t convert(uint32_t px)
+{
+	return lut_hi[px >> 8] | lut_lo[px & 0xFFU];
+}
+ 
+void color_order_apply(uint8_t *px, uint32_t count)
+{
+	uint16_t *p16 = reinterpret_cast<uint16_t *>(px);
+ 
+	if ((count > 0U) && ((reinterpret_cast<uintptr_t>(p16) & 2U) != 0U)) {
+		*p16 = static_cast<uint16_t>(convert(*p16));
+		++p16;
+		--count;
+	}
+ 
+	uint32_t *p32 = reinterpret_cast<uint32_t *>(p16);
+ 
+	for (uint32_t n = count / 2U; n > 0U; --n) {
+		uint32_t v = *p32;
+ 
+		*p32++ = convert(v & 0xFFFFU) | (convert(v >> 16) << 16);
+	}
+	if ((count & 1U) != 0U) {
+		p16 = reinterpret_cast<uint16_t *>(p32);
+		*p16 = static_cast<uint16_t>(convert(*p16));
+	}
+}
+} // namespace display
@@ -0,0 +1,15 @@
+#pragma once
+ 
+#include <cstdint>
+ 
+namespace display {
+/* Builds the remap tables for CONFIG_APP_PANEL_COLOR_ORDER_*. Call once
+ * before the first color_order_apply().
+ */
+void color_order_init();
+ 
+/* Converts 'count' LVGL RGB565 pixels in place into the panel's channel
+ * order and byte order (CONFIG_LV_COLOR_16_SWAP) in a single pass.
+ */
+void color_order_apply(uint8_t *px, uint32_t count);
+} // namespace display
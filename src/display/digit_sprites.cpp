@@ -0,0 +1,237 @@
+#include "digit_sprites.hpp"
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <lvgl.h>
+#include <string.h>
+#include <cstdint>
+ 
+LOG_MODULE_REGISTER(digit_sprites, LOG_LEVEL_INF);
+ 
+/* Pre-rendered digit glyphs. Every font/colour pair used by a sprite label
+ * gets one opaque RGB565 tile per glyph, rendered once through a canvas on
+ * the label's background colour. Drawing a sprite label is then one opaque
+ * same-format image draw per character: DMA2D blits it when that draw unit
+ * is enabled, otherwise the software blender copies it row by row. No glyph
+ * decoding or alpha blending happens on redraw.
+ *
+ * Tiles are kept in native RGB565: the flush path byte-swaps whole areas
+ * for the SSD1351, so pre-swapped tiles would be swapped twice.
+ */
+namespace display {
+namespace {
+constexpr char kGlyphs[] = "0123456789:%-";
+constexpr uint32_t kGlyphCount = sizeof(kGlyphs) - 1U;
+constexpr uint32_t kMaxSets = 3;
+constexpr uint32_t kMaxLabels = 4;
+constexpr uint32_t kMaxText = 8;
+ 
+struct SpriteSet {
+	const lv_font_t *font;
+	lv_color_t fg;
+	lv_color_t bg;
+	int32_t height;
+	lv_draw_buf_t *tiles[kGlyphCount];
+};
+ 
+struct SpriteLabel {
+	lv_obj_t *obj;
+	lv_obj_t *source;
+	SpriteSet *set;
+	char text[kMaxText];
+};
+} // namespace
+ 
+static SpriteSet sets[kMaxSets];
+static uint32_t set_count;
+static SpriteLabel labels[kMaxLabels];
+static uint32_t label_count;
+ 
+static int32_t glyph_index(char c)
+{
+	const char *pos = strchr(kGlyphs, c);
+ 
+	return ((c != '\0') && (pos != nullptr)) ? static_cast<int32_t>(pos - kGlyphs) : -1;
+}
+ 
+static void render_set(SpriteSet *set)
+{
+	lv_obj_t *canvas = lv_canvas_create(lv_layer_top());
+	char text[2] = {};
+ 
+	lv_obj_add_flag(canvas, LV_OBJ_FLAG_HIDDEN);
+	for (uint32_t i = 0; i < kGlyphCount; ++i) {
+		int32_t width = lv_font_get_glyph_width(set->font, kGlyphs[i], 0);
+ 
+		if (set->tiles[i] == nullptr) {
+			set->tiles[i] = lv_draw_buf_create(MAX(width, 1), set->height,
+							   LV_COLOR_FORMAT_RGB565, LV_STRIDE_AUTO);
+			if (set->tiles[i] == nullptr) {
+				LOG_ERR("No memory for glyph tiles");
+				break;
+			}
+		}
+ 
+		lv_layer_t layer;
+		lv_draw_label_dsc_t dsc;
+		lv_area_t area = {0, 0, width - 1, set->height - 1};
+ 
+		text[0] = kGlyphs[i];
+		lv_canvas_set_draw_buf(canvas, set->tiles[i]);
+		lv_canvas_fill_bg(canvas, set->bg, LV_OPA_COVER);
+		lv_canvas_init_layer(canvas, &layer);
+		lv_draw_label_dsc_init(&dsc);
+		dsc.font = set->font;
+		dsc.color = set->fg;
+		dsc.text = text;
+		lv_draw_label(&layer, &dsc, &area);
+		lv_canvas_finish_layer(canvas, &layer);
+	}
+	lv_obj_delete(canvas);
+}
+ 
+static SpriteSet *find_set(const lv_font_t *font, lv_color_t fg, lv_color_t bg)
+{
+	for (uint32_t i = 0; i < set_count; ++i) {
+		if ((sets[i].font == font) && lv_color_eq(sets[i].fg, fg) && lv_color_eq(sets[i].bg, bg)) {
+			return &sets[i];
+		}
+	}
+	if (set_count == kMaxSets) {
+		return nullptr;
+	}
+ 
+	SpriteSet *set = &sets[set_count++];
+ 
+	set->font = font;
+	set->fg = fg;
+	set->bg = bg;
+	set->height = lv_font_get_line_height(font);
+	render_set(set);
+	return set;
+}
+ 
+static lv_color_t background_of(lv_obj_t *obj)
+{
+	/* First opaque ancestor; the dashboard labels sit on the flat screen. */
+	for (lv_obj_t *p = lv_obj_get_parent(obj); p != nullptr; p = lv_obj_get_parent(p)) {
+		if (lv_obj_get_style_bg_opa(p, LV_PART_MAIN) == LV_OPA_COVER) {
+			return lv_obj_get_style_bg_color(p, LV_PART_MAIN);
+		}
+	}
+	return lv_color_black();
+}
+ 
+static int32_t text_width(const SpriteLabel *label)
+{
+	int32_t width = 0;
+ 
+	for (const char *c = label->text; *c != '\0'; ++c) {
+		int32_t idx = glyph_index(*c);
+ 
+		if (idx >= 0) {
+			width += label->set->tiles[idx]->header.w;
+		}
+	}
+	return MAX(width, 1);
+}
+ 
+static void on_draw(lv_event_t *e)
+{
+	auto *label = static_cast<SpriteLabel *>(lv_event_get_user_data(e));
+	lv_layer_t *layer = lv_event_get_layer(e);
+	lv_area_t coords;
+	lv_draw_image_dsc_t dsc;
+ 
+	lv_obj_get_coords(label->obj, &coords);
+	lv_draw_image_dsc_init(&dsc);
+	for (const char *c = label->text; *c != '\0'; ++c) {
+		int32_t idx = glyph_index(*c);
+ 
+		if ((idx < 0) || (label->set->tiles[idx] == nullptr)) {
+			continue;
+		}
+ 
+		const lv_draw_buf_t *tile = label->set->tiles[idx];
+		lv_area_t area = {coords.x1, coords.y1, coords.x1 + tile->header.w - 1,
+				  coords.y1 + tile->header.h - 1};
+ 
+		dsc.src = tile;
+		lv_draw_image(layer, &dsc, &area);
+		coords.x1 += tile->header.w;
+	}
+}
+ 
+lv_obj_t *sprite_label_replace(lv_obj_t *source)
+{
+	if ((source == nullptr) || (label_count == kMaxLabels)) {
+		return source;
+	}
+ 
+	SpriteSet *set = find_set(lv_obj_get_style_text_font(source, LV_PART_MAIN),
+				  lv_obj_get_style_text_color(source, LV_PART_MAIN),
+				  background_of(source));
+ 
+	if ((set == nullptr) || (set->tiles[kGlyphCount - 1U] == nullptr)) {
+		return source;
+	}
+ 
+	SpriteLabel *label = &labels[label_count++];
+	lv_obj_t *obj = lv_obj_create(lv_obj_get_parent(source));
+ 
+	lv_obj_remove_style_all(obj);
+	lv_obj_remove_flag(obj, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+	lv_obj_set_size(obj, 1, set->height);
+	lv_obj_set_align(obj, lv_obj_get_style_align(source, LV_PART_MAIN));
+	lv_obj_set_pos(obj, lv_obj_get_x_aligned(source), lv_obj_get_y_aligned(source));
+	lv_obj_add_event_cb(obj, on_draw, LV_EVENT_DRAW_MAIN, label);
+	lv_obj_add_flag(source, LV_OBJ_FLAG_HIDDEN);
+ 
+	label->obj = obj;
+	label->source = source;
+	label->set = set;
+	label->text[0] = '\0';
+	return obj;
+}
+ 
+static SpriteLabel *find_label(lv_obj_t *obj)
+{
+	for (uint32_t i = 0; i < label_count; ++i) {
+		if (labels[i].obj == obj) {
+			return &labels[i];
+		}
+	}
+	return nullptr;
+}
+ 
+void sprite_label_set_text(lv_obj_t *obj, const char *text)
+{
+	SpriteLabel *label = find_label(obj);
+ 
+	if (label == nullptr) {
+		/* Not replaced (cache full): fall back to the plain label. */
+		lv_label_set_text(obj, text);
+		return;
+	}
+ 
+	size_t len = strnlen(text, sizeof(label->text) - 1U);
+ 
+	memcpy(label->text, text, len);
+	label->text[len] = '\0';
+	lv_obj_set_width(obj, text_width(label));
+	lv_obj_invalidate(obj);
+}
+ 
+void digit_sprites_refresh()
+{
+	for (uint32_t i = 0; i < label_count; ++i) {
+		SpriteLabel *label = &labels[i];
+		lv_color_t bg = background_of(label->source);
+ 
+		if (!lv_color_eq(label->set->bg, bg)) {
+			label->set->bg = bg;
+			render_set(label->set);
+		}
+		lv_obj_invalidate(label->obj);
+	}
+}
+} // namespace display
@@ -0,0 +1,18 @@
+#pragma once
+ 
+struct _lv_obj_t;
+ 
+namespace display {
+/* Replaces an LVGL label showing digits by a sprite label at the same place
+ * (same parent, alignment, offset, font and text colour); the label itself is
+ * hidden. Returns the new object, or the label if the cache is full.
+ * Call with the LVGL lock held.
+ */
+struct _lv_obj_t *sprite_label_replace(struct _lv_obj_t *label);
+ 
+/* Sets the text; characters outside "0-9:%-" are skipped. */
+void sprite_label_set_text(struct _lv_obj_t *obj, const char *text);
+ 
+/* Re-renders all glyph tiles after the background they sit on changed. */
+void digit_sprites_refresh();
+} // namespace display
@@ -0,0 +1,473 @@
+#include "disp_io.hpp"
+#include "color_order.hpp"
+#include "../monitor/flush_stats.hpp"
+#include <zephyr/device.h>
+#include <zephyr/drivers/display.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <lvgl.h>
+#include <lvgl_zephyr.h>
+#include <errno.h>
+#include <cstdint>
+ 
+#define DISP_IO_STACK_SIZE 2048
+#define DISP_IO_PRIO 2
+#define DISP_IO_QUEUE_LEN 4
+#define DISP_IO_CHECK_MAX 16
+#define DISP_IO_CHECK_XFER_US 2000
+ 
+LOG_MODULE_REGISTER(disp_io, LOG_LEVEL_INF);
+ 
+/* All display driver calls go through this thread. With the D-cache on, the
+ * STM32 SPI driver only accepts DMA buffers in non-cacheable memory, and the
+ * ssd135x/mipi_dbi drivers build their command bytes on the caller's stack.
+ * This thread's stack is in the .nocache region and the pixel buffers are in
+ * SRAM1/SRAM2 (marked non-cacheable in the devicetree), so every transfer is
+ * DMA-safe without cache maintenance. The display is deferred-init for the
+ * same reason: its init sequence runs here rather than on the init stack.
+ *
+ * Flushes are asynchronous: flush_cb only queues the area and returns, so
+ * LVGL renders the next area into the other buffer while this thread sends
+ * the current one. Completion is signalled with the flush_done semaphore
+ * only, never with lv_display_flush_ready(): LVGL calls flush_wait_cb before
+ * it reuses a buffer, and a second completion path would leave a stale
+ * token there that lets LVGL draw into a buffer DMA is still reading. Writes
+ * carry a sequence number so out-of-order completion would show up in the
+ * stats.
+ */
+namespace display {
+namespace {
+enum class Op : uint8_t {
+	Init,
+	Write,
+	BlankingOff,
+};
+ 
+struct IoReq {
+	Op op;
+	bool synthetic; /* check/bench traffic, not an LVGL flush */
+	uint32_t seq;
+	uint16_t x;
+	uint16_t y;
+	uint16_t w;
+	uint16_t h;
+	const uint8_t *buf;
+	struct k_sem *done;
+	int *rc;
+};
+ 
+using WriteFn = int (*)(const IoReq *req);
+ 
+/* Timeline of one 'oled flushcheck' run, indexed by submission order. */
+struct CheckLog {
+	uint32_t submit_ret[DISP_IO_CHECK_MAX];
+	uint32_t xfer_end[DISP_IO_CHECK_MAX];
+	uint32_t done_seq[DISP_IO_CHECK_MAX];
+	uint32_t completed;
+};
+} // namespace
+ 
+static const struct device *const disp_dev = DEVICE_DT_GET(DT_CHOSEN(zephyr_display));
+ 
+#if defined(CONFIG_NOCACHE_MEMORY)
+Z_KERNEL_STACK_DEFINE_IN(disp_io_stack, DISP_IO_STACK_SIZE, __nocache);
+#else
+K_KERNEL_STACK_DEFINE(disp_io_stack, DISP_IO_STACK_SIZE);
+#endif
+static struct k_thread disp_io_thread;
+K_MSGQ_DEFINE(io_q, sizeof(IoReq), DISP_IO_QUEUE_LEN, 4);
+static K_SEM_DEFINE(flush_done, 0, 1);
+static K_MUTEX_DEFINE(call_lock);
+static bool started;
+static lv_display_t *lv_disp;
+ 
+static int panel_write(const IoReq *req);
+static WriteFn writer = panel_write;
+static CheckLog *check_log;
+ 
+/* Written by the LVGL thread (submitted, waits, wait_cyc) or by disp_io
+ * (completed, out_of_order); readers only need a consistent-enough view.
+ */
+static uint32_t submitted;
+static uint32_t completed;
+static uint32_t out_of_order;
+static uint32_t waits;
+static uint64_t wait_cyc;
+static uint32_t wait_cyc_max;
+ 
+static void submit(IoReq *req)
+{
+	req->op = Op::Write;
+	req->seq = ++submitted;
+	(void)k_msgq_put(&io_q, req, K_FOREVER);
+}
+ 
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+	IoReq req = {};
+	ARG_UNUSED(disp);
+ 
+	req.x = static_cast<uint16_t>(area->x1);
+	req.y = static_cast<uint16_t>(area->y1);
+	req.w = static_cast<uint16_t>(lv_area_get_width(area));
+	req.h = static_cast<uint16_t>(lv_area_get_height(area));
+	req.buf = px_map;
+	req.done = &flush_done;
+#if defined(CONFIG_APP_PANEL_COLOR_ORDER_RGB)
+#if defined(CONFIG_LV_COLOR_16_SWAP)
+	lv_draw_sw_rgb565_swap(px_map, static_cast<uint32_t>(req.w) * req.h);
+#endif
+#else
+	color_order_apply(px_map, static_cast<uint32_t>(req.w) * req.h);
+#endif
+	submit(&req);
+}
+ 
+/* Called by LVGL before every reuse of a flushed buffer; it clears its
+ * flushing flag itself after this returns. Each LVGL flush gives flush_done
+ * exactly once, so this consumes the token of the previous flush. Only
+ * waits that actually block are counted.
+ */
+static void flush_wait_cb(lv_display_t *disp)
+{
+	ARG_UNUSED(disp);
+ 
+	if (k_sem_take(&flush_done, K_NO_WAIT) == 0) {
+		return;
+	}
+ 
+	uint32_t start = k_cycle_get_32();
+ 
+	(void)k_sem_take(&flush_done, K_FOREVER);
+ 
+	uint32_t spent = k_cycle_get_32() - start;
+ 
+	++waits;
+	wait_cyc += spent;
+	wait_cyc_max = MAX(wait_cyc_max, spent);
+}
+ 
+static int bring_up()
+{
+	int rc = device_init(disp_dev);
+ 
+	if ((rc != 0) && (rc != -EALREADY)) {
+		LOG_ERR("Display init failed: %d", rc);
+		return rc;
+	}
+ 
+	rc = lvgl_init();
+	if (rc != 0) {
+		LOG_ERR("LVGL init failed: %d", rc);
+		return rc;
+	}
+ 
+#if !defined(CONFIG_APP_PANEL_COLOR_ORDER_RGB)
+	color_order_init();
+#endif
+	lvgl_lock();
+	lv_disp = lv_display_get_default();
+	lv_display_set_flush_cb(lv_disp, flush_cb);
+	lv_display_set_flush_wait_cb(lv_disp, flush_wait_cb);
+	lvgl_unlock();
+	return 0;
+}
+ 
+static int panel_write(const IoReq *req)
+{
+	struct display_buffer_descriptor desc = {};
+ 
+	desc.buf_size = static_cast<uint32_t>(req->w) * req->h * (LV_COLOR_DEPTH / 8);
+	desc.width = req->w;
+	desc.height = req->h;
+	desc.pitch = req->w;
+	return display_write(disp_dev, req->x, req->y, &desc, req->buf);
+}
+ 
+/* Stand-in for the panel during 'oled flushcheck': a transfer that takes
+ * DISP_IO_CHECK_XFER_US without using the CPU, like SPI DMA.
+ */
+static int mock_write(const IoReq *req)
+{
+	ARG_UNUSED(req);
+	k_sleep(K_USEC(DISP_IO_CHECK_XFER_US));
+	return 0;
+}
+ 
+static int execute(const IoReq *req)
+{
+	uint32_t start;
+	int rc;
+ 
+	switch (req->op) {
+	case Op::Init:
+		return bring_up();
+	case Op::Write:
+		start = k_cycle_get_32();
+		rc = writer(req);
+		if (!req->synthetic) {
+			monitor::flush_stats_record_flush(k_cycle_get_32() - start);
+		}
+		return rc;
+	case Op::BlankingOff:
+		return display_blanking_off(disp_dev);
+	default:
+		return -ENOTSUP;
+	}
+}
+ 
+static void disp_io_worker(void *p1, void *p2, void *p3)
+{
+	IoReq req;
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+ 
+	while (true) {
+		(void)k_msgq_get(&io_q, &req, K_FOREVER);
+		int rc = execute(&req);
+ 
+		if (req.op == Op::Write) {
+			if (rc != 0) {
+				LOG_WRN("display_write failed: %d", rc);
+			}
+			if (req.seq != completed + 1U) {
+				++out_of_order;
+			}
+			completed = req.seq;
+			if (check_log != nullptr) {
+				uint32_t i = check_log->completed++;
+ 
+				check_log->xfer_end[i] = k_cycle_get_32();
+				check_log->done_seq[i] = req.seq;
+			}
+		}
+		if (req.rc != nullptr) {
+			*req.rc = rc;
+		}
+		k_sem_give(req.done);
+	}
+}
+ 
+/* Runs one request on the disp_io thread and waits for its result. */
+static int call(Op op)
+{
+	struct k_sem done;
+	int rc = -EIO;
+	IoReq req = {};
+ 
+	k_sem_init(&done, 0, 1);
+	req.op = op;
+	req.done = &done;
+	req.rc = &rc;
+ 
+	k_mutex_lock(&call_lock, K_FOREVER);
+	(void)k_msgq_put(&io_q, &req, K_FOREVER);
+	(void)k_sem_take(&done, K_FOREVER);
+	k_mutex_unlock(&call_lock);
+	return rc;
+}
+ 
+/* Waits until the last LVGL flush has reached the panel. Call with the LVGL
+ * lock held, so no new one can be queued.
+ */
+static void drain()
+{
+	while (completed != submitted) {
+		k_sleep(K_MSEC(1));
+	}
+}
+ 
+int disp_io_start()
+{
+	if (started) {
+		return -EALREADY;
+	}
+ 
+	k_thread_create(&disp_io_thread, disp_io_stack, K_KERNEL_STACK_SIZEOF(disp_io_stack),
+			disp_io_worker, nullptr, nullptr, nullptr, DISP_IO_PRIO, 0, K_NO_WAIT);
+	k_thread_name_set(&disp_io_thread, "disp_io");
+	started = true;
+	return call(Op::Init);
+}
+ 
+int disp_io_blanking_off()
+{
+	return started ? call(Op::BlankingOff) : -ENODEV;
+}
+ 
+void disp_io_get_stats(DispIoStats *out)
+{
+	out->submitted = submitted;
+	out->completed = completed;
+	out->out_of_order = out_of_order;
+	out->waits = waits;
+	out->wait_cyc = wait_cyc;
+	out->wait_cyc_max = wait_cyc_max;
+}
+ 
+int disp_io_check(uint32_t writes, DispIoCheck *out)
+{
+	static CheckLog log;
+	static uint16_t px[8];
+	struct k_sem done;
+	uint32_t first;
+ 
+	if (!started) {
+		return -ENODEV;
+	}
+	if ((writes == 0U) || (writes > DISP_IO_CHECK_MAX)) {
+		return -EINVAL;
+	}
+ 
+	/* LVGL is held off so its flushes can't interleave with the check. */
+	lvgl_lock();
+	k_mutex_lock(&call_lock, K_FOREVER);
+	drain();
+	k_sem_init(&done, 0, DISP_IO_CHECK_MAX);
+	log = {};
+	check_log = &log;
+	writer = mock_write;
+	first = submitted + 1U;
+ 
+	uint32_t start = k_cycle_get_32();
+ 
+	for (uint32_t i = 0; i < writes; ++i) {
+		IoReq req = {};
+ 
+		req.synthetic = true;
+		req.w = 1;
+		req.h = 1;
+		req.buf = reinterpret_cast<const uint8_t *>(px);
+		req.done = &done;
+		submit(&req);
+		log.submit_ret[i] = k_cycle_get_32();
+	}
+	for (uint32_t i = 0; i < writes; ++i) {
+		(void)k_sem_take(&done, K_FOREVER);
+	}
+ 
+	uint32_t spent = k_cycle_get_32() - start;
+ 
+	writer = panel_write;
+	check_log = nullptr;
+	k_mutex_unlock(&call_lock);
+	lvgl_unlock();
+ 
+	*out = {};
+	out->writes = writes;
+	out->total_us = k_cyc_to_us_floor32(spent);
+	out->xfer_us = DISP_IO_CHECK_XFER_US;
+	for (uint32_t i = 0; i < writes; ++i) {
+		uint32_t ret_us = k_cyc_to_us_floor32(log.submit_ret[i] - start);
+ 
+		out->submit_max_us = MAX(out->submit_max_us, ret_us);
+		if (log.done_seq[i] != first + i) {
+			++out->misordered;
+		}
+		/* Within the queue depth the caller must be back before the
+		 * transfer of its own write has finished.
+		 */
+		if ((i < DISP_IO_QUEUE_LEN) &&
+		    (static_cast<int32_t>(log.xfer_end[i] - log.submit_ret[i]) <= 0)) {
+			++out->blocked;
+		}
+	}
+	return ((out->misordered == 0U) && (out->blocked == 0U)) ? 0 : -EIO;
+}
+int disp_io_bench(uint16_t w, uint16_t h, uint32_t frames, DispIoBench *out)
+{
+	k_thread_runtime_stats_t io_before;
+	k_thread_runtime_stats_t io_after;
+	k_thread_runtime_stats_t all_before;
+	k_thread_runtime_stats_t all_after;
+	struct k_sem done;
+	uint32_t writes = 0;
+ 
+	if (!started) {
+		return -ENODEV;
+	}
+ 
+	lvgl_lock();
+	/* The active LVGL draw buffer is DMA-safe memory of a known size; LVGL
+	 * redraws the whole screen afterwards.
+	 */
+	lv_draw_buf_t *db = lv_display_get_buf_active(lv_disp);
+	uint32_t lines = (db != nullptr) ? db->data_size / (static_cast<uint32_t>(w) * 2U) : 0U;
+ 
+	if ((w == 0U) || (h == 0U) || (frames == 0U) ||
+	    (w > lv_display_get_horizontal_resolution(lv_disp)) ||
+	    (h > lv_display_get_vertical_resolution(lv_disp)) || (lines == 0U)) {
+		lvgl_unlock();
+		return -EINVAL;
+	}
+	lines = MIN(lines, static_cast<uint32_t>(h));
+ 
+	/* With a single draw buffer it may still be in flight from LVGL's last
+	 * flush; wait for that before overwriting it.
+	 */
+	k_mutex_lock(&call_lock, K_FOREVER);
+	drain();
+ 
+	uint16_t *px = reinterpret_cast<uint16_t *>(db->data);
+ 
+	for (uint32_t i = 0; i < lines * w; ++i) {
+		px[i] = ((i / w) & 1U) ? 0x07E0U : 0x001FU; /* swapped-order stripes */
+	}
+ 
+	k_sem_init(&done, 0, K_SEM_MAX_LIMIT);
+	(void)k_thread_runtime_stats_get(&disp_io_thread, &io_before);
+	(void)k_thread_runtime_stats_all_get(&all_before);
+ 
+	uint32_t start = k_cycle_get_32();
+ 
+	for (uint32_t f = 0; f < frames; ++f) {
+		for (uint32_t y = 0; y < h; y += lines) {
+			IoReq req = {};
+ 
+			req.synthetic = true;
+			req.y = static_cast<uint16_t>(y);
+			req.w = w;
+			req.h = static_cast<uint16_t>(MIN(lines, h - y));
+			req.buf = db->data;
+			req.done = &done;
+			submit(&req);
+			++writes;
+		}
+	}
+	for (uint32_t i = 0; i < writes; ++i) {
+		(void)k_sem_take(&done, K_FOREVER);
+	}
+ 
+	uint32_t spent = k_cycle_get_32() - start;
+ 
+	(void)k_thread_runtime_stats_get(&disp_io_thread, &io_after);
+	(void)k_thread_runtime_stats_all_get(&all_after);
+	k_mutex_unlock(&call_lock);
+	lv_obj_invalidate(lv_screen_active());
+	lvgl_unlock();
+ 
+	uint64_t all_cyc = all_after.execution_cycles - all_before.execution_cycles;
+	uint64_t busy_cyc = all_after.total_cycles - all_before.total_cycles;
+	uint32_t spent_us = MAX(k_cyc_to_us_floor32(spent), 1U);
+ 
+	*out = {};
+	out->frames = frames;
+	out->writes = writes;
+	out->frame_bytes = static_cast<uint32_t>(w) * h * 2U;
+	out->frame_us = spent_us / frames;
+	out->bytes_per_s = static_cast<uint32_t>((static_cast<uint64_t>(out->frame_bytes) * frames *
+						 USEC_PER_SEC) / spent_us);
+	out->io_cpu_us = static_cast<uint32_t>(
+		k_cyc_to_us_floor64(io_after.execution_cycles - io_before.execution_cycles) / frames);
+	out->busy_permille = (all_cyc > 0U) ? static_cast<uint32_t>((busy_cyc * 1000U) / all_cyc)
+					    : 0U;
+	out->spi_hz = disp_io_link_hz();
+	return 0;
+}
+ 
+uint32_t disp_io_link_hz()
+{
+	return DT_PROP_OR(DT_CHOSEN(zephyr_display), mipi_max_frequency, 0);
+}
+} // namespace display
@@ -0,0 +1,63 @@
+#pragma once
+ 
+#include <cstdint>
+ 
+namespace display {
+struct DispIoStats {
+	uint32_t submitted;    /* areas queued by LVGL */
+	uint32_t completed;    /* sequence number of the last finished write */
+	uint32_t out_of_order;
+	uint32_t waits;        /* times LVGL had to wait for a buffer */
+	uint64_t wait_cyc;
+	uint32_t wait_cyc_max;
+};
+ 
+struct DispIoCheck {
+	uint32_t writes;
+	uint32_t xfer_us;       /* simulated transfer time per write */
+	uint32_t total_us;
+	uint32_t submit_max_us; /* latest return of a submit, from the start */
+	uint32_t misordered;    /* completions not in submission order */
+	uint32_t blocked;       /* submits that waited for their own transfer */
+};
+ 
+struct DispIoBench {
+	uint32_t frames;
+	uint32_t writes;        /* display_write() calls (strips of the buffer) */
+	uint32_t frame_bytes;
+	uint32_t frame_us;      /* wall time per frame */
+	uint32_t bytes_per_s;
+	uint32_t io_cpu_us;     /* disp_io thread CPU time per frame */
+	uint32_t busy_permille; /* whole-system CPU busy during the run */
+	uint32_t spi_hz;        /* mipi-max-frequency from the devicetree */
+};
+ 
+/* Brings the display up from the disp_io thread, initializes LVGL and takes
+ * over its flush path. Blocks until done. Call once, before any LVGL use.
+ */
+int disp_io_start();
+ 
+/* Runs display_blanking_off() on the disp_io thread. */
+int disp_io_blanking_off();
+ 
+void disp_io_get_stats(DispIoStats *out);
+ 
+/* Self-check of the asynchronous flush path: queues 'writes' (1..16) areas
+ * through it against a mock panel whose transfers sleep, then checks that
+ * completions arrive in submission order and that submitting didn't wait
+ * for the transfer. Returns 0 on pass, -EIO on fail.
+ */
+int disp_io_check(uint32_t writes, DispIoCheck *out);
+ 
+/* Pushes 'frames' synthetic w x h areas (top-left aligned, in strips of the
+ * LVGL draw buffer) through display_write() and measures the link. LVGL is
+ * paused for the run and redraws the screen afterwards.
+ */
+int disp_io_bench(uint16_t w, uint16_t h, uint32_t frames, DispIoBench *out);
+ 
+/* Display link clock from the devicetree (0 if the panel has none). The
+ * mipi_dbi SPI driver takes it from the devicetree on every write, so it
+ * can't be changed at runtime.
+ */
+uint32_t disp_io_link_hz();
+} // namespace display
@@ -0,0 +1,46 @@
+#include "draw_buffers.hpp"
+#include <zephyr/devicetree.h>
+#include <zephyr/kernel.h>
+#include <zephyr/linker/devicetree_regions.h>
+#include <zephyr/logging/log.h>
+#include <lvgl.h>
+#if defined(CONFIG_SOC_SERIES_STM32H7X)
+#include <stm32_ll_bus.h>
+#endif
+#include <cstdint>
+ 
+LOG_MODULE_REGISTER(draw_buffers, LOG_LEVEL_INF);
+ 
+/* Ping-pong draw buffers. With LV_Z_DOUBLE_VDB + LV_Z_FLUSH_THREAD the glue
+ * hands a finished buffer to its flush thread, which blocks in display_write()
+ * until the SPI DMA completion interrupt releases it and then calls
+ * lv_display_flush_ready(). Meanwhile LVGL renders into the other buffer.
+ * Keeping the two in different D2 SRAM banks lets the CPU write one while
+ * DMA1 reads the other without contending for the same bank.
+ */
+#define DISP_NODE DT_CHOSEN(zephyr_display)
+#define BUF_SECTION(label) __attribute__((section(LINKER_DT_NODE_REGION_NAME(DT_NODELABEL(label)))))
+ 
+namespace display {
+constexpr uint32_t kBufBytes = DT_PROP(DISP_NODE, width) * CONFIG_APP_LVGL_PINGPONG_LINES *
+			       (LV_COLOR_DEPTH / 8);
+ 
+static uint8_t buf_a[kBufBytes] BUF_SECTION(sram1) __aligned(32);
+static uint8_t buf_b[kBufBytes] BUF_SECTION(sram2) __aligned(32);
+ 
+void draw_buffers_attach(lv_display_t *disp)
+{
+	if (disp == nullptr) {
+		return;
+	}
+ 
+#if defined(LL_AHB2_GRP1_PERIPH_D2SRAM1)
+	/* D2 SRAM clocks are off after reset on some H7 revisions. */
+	LL_AHB2_GRP1_EnableClock(LL_AHB2_GRP1_PERIPH_D2SRAM1 | LL_AHB2_GRP1_PERIPH_D2SRAM2);
+#endif
+ 
+	lv_display_set_buffers(disp, buf_a, buf_b, sizeof(buf_a), LV_DISPLAY_RENDER_MODE_PARTIAL);
+	LOG_INF("Draw buffers: 2 x %u B (%u lines) at %p / %p", kBufBytes,
+		CONFIG_APP_LVGL_PINGPONG_LINES, static_cast<void *>(buf_a), static_cast<void *>(buf_b));
+}
+} // namespace display
@@ -0,0 +1,10 @@
+#pragma once
+ 
+struct _lv_display_t;
+ 
+namespace display {
+/* Replaces the LVGL glue's draw buffers with two buffers in separate SRAM
+ * banks. Call once with the LVGL lock held, before the first refresh.
+ */
+void draw_buffers_attach(struct _lv_display_t *disp);
+} // namespace display
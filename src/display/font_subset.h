@@ -0,0 +1,30 @@
+#pragma once
+ 
+#include <lvgl.h>
+#include <stddef.h>
+ 
+#ifdef __cplusplus
+extern "C" {
+#endif
+ 
+/* Subsetted fonts generated at build time by scripts/font_subset.py
+ * (CONFIG_APP_FONT_SUBSET). Only the glyphs found in label text are kept.
+ */
+struct app_font_variant {
+	const char *name;          /* "4bpp", "4bpp_rle", "2bpp" */
+	const lv_font_t *font;
+	size_t bitmap_bytes;       /* size of glyph_bitmap[] in flash */
+};
+ 
+extern const struct app_font_variant app_font_variants[];
+extern const size_t app_font_variant_count;
+ 
+/* Glyphs the subset was generated for. */
+extern const char app_font_glyphs[];
+ 
+/* Variant selected by CONFIG_APP_FONT_SUBSET_VARIANT, used by the dashboard. */
+extern const lv_font_t *const app_font_subset;
+ 
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,112 @@
+#include "refr_governor.hpp"
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <lvgl.h>
+#include <cstdint>
+ 
+LOG_MODULE_REGISTER(refr_governor, LOG_LEVEL_INF);
+ 
+/* Adaptive refresh period. While something changes the refresh timer runs at
+ * LV_DEF_REFR_PERIOD; after APP_REFR_GOV_IDLE_FRAMES refreshes with no
+ * invalidation and no running animation it is slowed down to
+ * APP_REFR_GOV_IDLE_PERIOD_MS. The first invalidation (label update,
+ * animation step, input) snaps it back and makes the timer ready. The glue's
+ * lv_timer_handler() run is scheduled ahead by the slow period, though, so
+ * code applying changes from outside the LVGL timers calls
+ * refr_governor_service() to render them without waiting for it. All
+ * callbacks run in the LVGL thread.
+ */
+namespace display {
+static lv_timer_t *refr_timer;
+static bool idle;
+static bool dirty;
+static bool woken;
+static uint32_t quiet_frames;
+static struct k_spinlock stats_lock;
+static uint64_t active_ms;
+static uint64_t idle_ms;
+static int64_t state_since_ms;
+static uint32_t wakeups;
+ 
+static void enter(bool to_idle)
+{
+	int64_t now = k_uptime_get();
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+ 
+	if (idle) {
+		idle_ms += static_cast<uint64_t>(now - state_since_ms);
+	} else {
+		active_ms += static_cast<uint64_t>(now - state_since_ms);
+	}
+	state_since_ms = now;
+	idle = to_idle;
+	if (!to_idle) {
+		wakeups++;
+	}
+	k_spin_unlock(&stats_lock, key);
+ 
+	lv_timer_set_period(refr_timer, to_idle ? CONFIG_APP_REFR_GOV_IDLE_PERIOD_MS
+						: LV_DEF_REFR_PERIOD);
+}
+ 
+static void on_display_event(lv_event_t *e)
+{
+	lv_event_code_t code = lv_event_get_code(e);
+ 
+	if (code == LV_EVENT_INVALIDATE_AREA) {
+		dirty = true;
+		if (idle) {
+			enter(false);
+			lv_timer_ready(refr_timer);
+			woken = true;
+		}
+	} else if (code == LV_EVENT_REFR_READY) {
+		if (dirty || (lv_anim_count_running() > 0U)) {
+			quiet_frames = 0;
+		} else if (!idle && (++quiet_frames >= CONFIG_APP_REFR_GOV_IDLE_FRAMES)) {
+			enter(true);
+		}
+		dirty = false;
+		woken = false;
+	}
+}
+ 
+void refr_governor_attach(lv_display_t *disp)
+{
+	if (disp == nullptr) {
+		return;
+	}
+ 
+	refr_timer = lv_display_get_refr_timer(disp);
+	if (refr_timer == nullptr) {
+		LOG_WRN("Display has no refresh timer");
+		return;
+	}
+ 
+	state_since_ms = k_uptime_get();
+	lv_display_add_event_cb(disp, on_display_event, LV_EVENT_INVALIDATE_AREA, nullptr);
+	lv_display_add_event_cb(disp, on_display_event, LV_EVENT_REFR_READY, nullptr);
+}
+ 
+void refr_governor_service()
+{
+	if (woken) {
+		woken = false;
+		lv_refr_now(nullptr);
+	}
+}
+ 
+void refr_governor_get(GovernorStats *out)
+{
+	int64_t now = k_uptime_get();
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+	uint64_t current = (refr_timer != nullptr) ? static_cast<uint64_t>(now - state_since_ms) : 0U;
+ 
+	out->idle = idle;
+	out->period_ms = idle ? CONFIG_APP_REFR_GOV_IDLE_PERIOD_MS : LV_DEF_REFR_PERIOD;
+	out->active_ms = active_ms + (idle ? 0U : current);
+	out->idle_ms = idle_ms + (idle ? current : 0U);
+	out->wakeups = wakeups;
+	k_spin_unlock(&stats_lock, key);
+}
+} // namespace display
@@ -0,0 +1,27 @@
+#pragma once
+ 
+#include <cstdint>
+ 
+struct _lv_display_t;
+ 
+namespace display {
+struct GovernorStats {
+	bool idle;
+	uint32_t period_ms;
+	uint64_t active_ms;
+	uint64_t idle_ms;
+	uint32_t wakeups;
+};
+ 
+/* Hooks the display's refresh timer. Call once with the LVGL lock held. */
+void refr_governor_attach(struct _lv_display_t *disp);
+void refr_governor_get(GovernorStats *out);
+ 
+/* Renders at once if an invalidation woke the governor since the last
+ * refresh. The Zephyr glue has already scheduled its next timer run up to
+ * the idle period ahead, and lv_timer_ready() alone doesn't pull that in.
+ * Call with the LVGL lock held, outside of a refresh, after applying
+ * changes from outside the LVGL timers.
+ */
+void refr_governor_service();
+} // namespace display
@@ -1,6 +1,7 @@
 #include "fpu_demo.hpp"
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
 #include <math.h>
 #include <cstdint>
  
@@ -17,27 +18,47 @@ static struct k_thread fpu_thread_b;
 static volatile float fpu_sink_a;
 static volatile float fpu_sink_b;
 static bool fpu_started;
+static atomic_t fpu_batches;
+static atomic_t fpu_min_cyc = ATOMIC_INIT(static_cast<atomic_val_t>(UINT32_MAX));
+static atomic_t fpu_last_cyc;
  
-static void fpu_worker(void *p1, void *p2, void *p3)
+static float fpu_batch(float *angle)
 {
 	constexpr float two_pi = 6.2831853F;
+	float acc = 0.0F;
+ 
+	for (int i = 0; i < FPU_WORK_ITERATIONS; ++i) {
+		*angle += 0.011F;
+		if (*angle > two_pi) {
+			*angle -= two_pi;
+		}
+		acc += sinf(*angle) * cosf(*angle * 0.73F);
+		acc += sqrtf(1.0F + (*angle * 0.25F));
+	}
+	return acc;
+}
+ 
+static void fpu_worker(void *p1, void *p2, void *p3)
+{
 	float angle = static_cast<float>(reinterpret_cast<intptr_t>(p1)) * 0.37F;
 	volatile float *const sink = reinterpret_cast<volatile float *>(p2);
 	ARG_UNUSED(p3);
  
 	while (true) {
-		float acc = 0.0F;
- 
-		for (int i = 0; i < FPU_WORK_ITERATIONS; ++i) {
-			angle += 0.011F;
-			if (angle > two_pi) {
-				angle -= two_pi;
-			}
-			acc += sinf(angle) * cosf(angle * 0.73F);
-			acc += sqrtf(1.0F + (angle * 0.25F));
-		}
+		uint32_t start = k_cycle_get_32();
  
-		*sink = acc;
+		*sink = fpu_batch(&angle);
+ 
+		/* Preemption only makes a batch longer, so the minimum is the clean figure. */
+		uint32_t spent = k_cycle_get_32() - start;
+		atomic_val_t min = atomic_get(&fpu_min_cyc);
+ 
+		while ((static_cast<uint32_t>(min) > spent) &&
+		       !atomic_cas(&fpu_min_cyc, min, static_cast<atomic_val_t>(spent))) {
+			min = atomic_get(&fpu_min_cyc);
+		}
+		atomic_set(&fpu_last_cyc, static_cast<atomic_val_t>(spent));
+		atomic_inc(&fpu_batches);
 		k_msleep(10);
 	}
 }
@@ -60,4 +81,26 @@ void start_fpu_demo()
  
 	fpu_started = true;
 	LOG_INF("FPU threads started");
-}
\ No newline at end of file
+}
+ 
+void fpu_demo_get_stats(FpuBatchStats *out)
+{
+	out->batches = static_cast<uint32_t>(atomic_get(&fpu_batches));
+	out->min_cyc = static_cast<uint32_t>(atomic_get(&fpu_min_cyc));
+	out->last_cyc = static_cast<uint32_t>(atomic_get(&fpu_last_cyc));
+}
+ 
+uint32_t fpu_demo_iterations_per_batch()
+{
+	return FPU_WORK_ITERATIONS;
+}
+ 
+uint32_t fpu_demo_run_batch()
+{
+	static volatile float sink;
+	float angle = 0.37F;
+	uint32_t start = k_cycle_get_32();
+ 
+	sink = fpu_batch(&angle);
+	return k_cycle_get_32() - start;
+}
@@ -1,3 +1,20 @@
 #pragma once
  
-void start_fpu_demo();
\ No newline at end of file
+#include <cstdint>
+ 
+void start_fpu_demo();
+ 
+/* Compute time of one worker batch (FPU_WORK_ITERATIONS), in CPU cycles. */
+struct FpuBatchStats {
+	uint32_t batches;
+	uint32_t min_cyc;
+	uint32_t last_cyc;
+};
+ 
+void fpu_demo_get_stats(FpuBatchStats *out);
+uint32_t fpu_demo_iterations_per_batch();
+ 
+/* Runs one batch on the calling thread, returns its length in cycles. Works
+ * without start_fpu_demo(), for 'perf fpu'.
+ */
+uint32_t fpu_demo_run_batch();
@@ -0,0 +1,496 @@
+#include "journal.hpp"
+#include "lvgl_demo.hpp"
+#include "monitor/top_collector.hpp"
+#include <zephyr/drivers/flash.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/timeutil.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cstdint>
+ 
+#define JOURNAL_STACK_SIZE 2048
+#define JOURNAL_PRIO 11
+ 
+LOG_MODULE_REGISTER(journal, LOG_LEVEL_INF);
+ 
+/* Append-only metrics journal in journal_partition.
+ *
+ * Layout: the partition is a ring of erase sectors. Every sector starts with
+ * a header block carrying a sequence number; the sector with the highest
+ * sequence is the one being filled. The rest of the sector is a run of
+ * fixed-size blocks. A block is accumulated in RAM and written once, so each
+ * flash word is programmed exactly once and a sector is erased only when the
+ * ring wraps onto it.
+ *
+ * Block: magic u16, payload length u16, boot number u32, then records. The
+ * first record of a block is a keyframe (deltas against zero), the following
+ * ones are deltas against the previous record, so every block decodes on its
+ * own. Record fields, LEB128 varints (signed ones zigzag-encoded):
+ * uptime_s, rtc_epoch, load_permille, heap_used, min_stack, fps.
+ * scripts/journal_decode.py decodes 'journal dump' output.
+ */
+namespace {
+constexpr uint32_t kSectorMagic = 0x4C4E524A; /* "JRNL" */
+constexpr uint16_t kBlockMagic = 0x424A;      /* "JB" */
+constexpr uint16_t kVersion = 1;
+constexpr uint32_t kBlockSize = CONFIG_APP_JOURNAL_BLOCK_SIZE;
+constexpr uint32_t kBlockHdrSize = 8;
+constexpr uint32_t kFieldCount = 6;
+constexpr uint32_t kMaxRecordSize = kFieldCount * 10;
+static_assert(kBlockHdrSize + kMaxRecordSize <= kBlockSize,
+	      "APP_JOURNAL_BLOCK_SIZE must hold at least one keyframe record");
+ 
+struct __packed SectorHeader {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t block_size;
+	uint32_t seq;
+};
+ 
+struct Record {
+	int64_t f[kFieldCount];
+};
+} // namespace
+ 
+static const struct flash_area *fa;
+static uint32_t sector_size;
+static uint32_t sector_count;
+static uint32_t cur_sector;
+static uint32_t cur_seq;
+static uint32_t write_off;
+static uint32_t boot_no;
+static bool journal_ready;
+ 
+static uint8_t block[kBlockSize];
+static uint32_t block_len;
+static Record prev_rec;
+static uint32_t block_records;
+static uint32_t records_total;
+static uint32_t blocks_written;
+static uint32_t sectors_erased;
+static uint32_t write_errors;
+static uint32_t records_lost;
+static K_MUTEX_DEFINE(journal_lock);
+ 
+K_THREAD_STACK_DEFINE(journal_stack, JOURNAL_STACK_SIZE);
+static struct k_thread journal_thread;
+static monitor::TopSnapshot journal_snap;
+static monitor::CycleTracker journal_tracker;
+ 
+static uint32_t put_varint(uint8_t *out, uint64_t v)
+{
+	uint32_t n = 0;
+ 
+	do {
+		uint8_t byte = static_cast<uint8_t>(v & 0x7FU);
+ 
+		v >>= 7;
+		out[n++] = (v != 0U) ? (byte | 0x80U) : byte;
+	} while (v != 0U);
+	return n;
+}
+ 
+static uint64_t zigzag(int64_t v)
+{
+	return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+ 
+static uint32_t sector_off(uint32_t sector)
+{
+	return sector * sector_size;
+}
+ 
+static bool read_sector_header(uint32_t sector, SectorHeader *hdr)
+{
+	if (flash_area_read(fa, sector_off(sector), hdr, sizeof(*hdr)) != 0) {
+		return false;
+	}
+	return (sys_le32_to_cpu(hdr->magic) == kSectorMagic) &&
+	       (sys_le16_to_cpu(hdr->version) == kVersion) &&
+	       (sys_le16_to_cpu(hdr->block_size) == kBlockSize);
+}
+ 
+static int start_sector(uint32_t sector, uint32_t seq)
+{
+	/* Not block[]: a rollover happens while it holds the pending records. */
+	static uint8_t hdr_block[kBlockSize];
+	SectorHeader hdr = {};
+	int rc;
+ 
+	rc = flash_area_erase(fa, sector_off(sector), sector_size);
+	if (rc != 0) {
+		return rc;
+	}
+	sectors_erased++;
+ 
+	/* The header occupies a whole block to keep every write block-aligned. */
+	memset(hdr_block, 0xFF, sizeof(hdr_block));
+	hdr.magic = sys_cpu_to_le32(kSectorMagic);
+	hdr.version = sys_cpu_to_le16(kVersion);
+	hdr.block_size = sys_cpu_to_le16(kBlockSize);
+	hdr.seq = sys_cpu_to_le32(seq);
+	memcpy(hdr_block, &hdr, sizeof(hdr));
+	rc = flash_area_write(fa, sector_off(sector), hdr_block, kBlockSize);
+	if (rc != 0) {
+		return rc;
+	}
+ 
+	cur_sector = sector;
+	cur_seq = seq;
+	write_off = sector_off(sector) + kBlockSize;
+	return 0;
+}
+ 
+/* Sets *erased if the whole block at off reads as erased flash. */
+static int block_erased(uint32_t off, bool *erased)
+{
+	uint8_t chunk[32];
+ 
+	*erased = true;
+	for (uint32_t pos = 0; pos < kBlockSize; pos += sizeof(chunk)) {
+		uint32_t len = MIN(static_cast<uint32_t>(sizeof(chunk)), kBlockSize - pos);
+		int rc = flash_area_read(fa, off + pos, chunk, len);
+ 
+		if (rc != 0) {
+			return rc;
+		}
+		for (uint32_t i = 0; i < len; ++i) {
+			if (chunk[i] != 0xFFU) {
+				*erased = false;
+				return 0;
+			}
+		}
+	}
+	return 0;
+}
+ 
+/* Finds the newest sector, the first erased block after its last written
+ * one and the last boot number recorded anywhere in the ring. Blocks that
+ * are neither valid nor erased (a write torn by a reset) are skipped: on
+ * ECC flash a partly programmed word can't be programmed again.
+ */
+static int scan()
+{
+	SectorHeader hdr;
+	bool found = false;
+	uint8_t head[kBlockHdrSize];
+ 
+	for (uint32_t s = 0; s < sector_count; ++s) {
+		if (read_sector_header(s, &hdr) && (!found || (sys_le32_to_cpu(hdr.seq) > cur_seq))) {
+			found = true;
+			cur_sector = s;
+			cur_seq = sys_le32_to_cpu(hdr.seq);
+		}
+	}
+	if (!found) {
+		LOG_INF("No journal found, formatting %u x %u KB", sector_count, sector_size / 1024U);
+		return start_sector(0, 1);
+	}
+ 
+	write_off = sector_off(cur_sector + 1U);
+	for (uint32_t s = 0; s < sector_count; ++s) {
+		if (!read_sector_header(s, &hdr)) {
+			continue;
+		}
+		for (uint32_t off = sector_off(s) + kBlockSize; off < sector_off(s + 1U);
+		     off += kBlockSize) {
+			if (flash_area_read(fa, off, head, sizeof(head)) != 0) {
+				return -EIO;
+			}
+			if (sys_get_le16(head) == kBlockMagic) {
+				boot_no = MAX(boot_no, sys_get_le32(&head[4]));
+				continue;
+			}
+ 
+			bool erased;
+ 
+			if (block_erased(off, &erased) != 0) {
+				return -EIO;
+			}
+			if (!erased) {
+				LOG_WRN("Skipping corrupt journal block at 0x%x", off);
+				continue;
+			}
+			if (s == cur_sector) {
+				write_off = off;
+			}
+			break;
+		}
+	}
+	return 0;
+}
+ 
+static int write_block()
+{
+	int rc;
+ 
+	if (block_len == kBlockHdrSize) {
+		return 0;
+	}
+ 
+	if (write_off >= sector_off(cur_sector + 1U)) {
+		rc = start_sector((cur_sector + 1U) % sector_count, cur_seq + 1U);
+		if (rc != 0) {
+			write_errors++;
+			records_lost += block_records;
+			block_len = kBlockHdrSize;
+			block_records = 0;
+			return rc;
+		}
+	}
+ 
+	sys_put_le16(kBlockMagic, block);
+	sys_put_le16(static_cast<uint16_t>(block_len - kBlockHdrSize), &block[2]);
+	sys_put_le32(boot_no, &block[4]);
+	memset(&block[block_len], 0xFF, kBlockSize - block_len);
+ 
+	rc = flash_area_write(fa, write_off, block, kBlockSize);
+	/* A failed write may have left the block partly programmed; move past
+	 * it either way so the next block goes to erased flash.
+	 */
+	write_off += kBlockSize;
+	if (rc == 0) {
+		blocks_written++;
+	} else {
+		write_errors++;
+		records_lost += block_records;
+	}
+	block_len = kBlockHdrSize;
+	block_records = 0;
+	return rc;
+}
+ 
+static uint32_t encode_record(const Record *rec, bool keyframe, uint8_t *out)
+{
+	uint32_t n = 0;
+ 
+	for (uint32_t i = 0; i < kFieldCount; ++i) {
+		int64_t base = keyframe ? 0 : prev_rec.f[i];
+ 
+		/* uptime only grows inside a block, everything else may go down. */
+		n += (i == 0U) ? put_varint(&out[n], static_cast<uint64_t>(rec->f[i] - base))
+			       : put_varint(&out[n], zigzag(rec->f[i] - base));
+	}
+	return n;
+}
+ 
+static void append_record(const Record *rec)
+{
+	uint8_t tmp[kMaxRecordSize];
+	uint32_t n = encode_record(rec, block_len == kBlockHdrSize, tmp);
+ 
+	if ((block_len + n) > kBlockSize) {
+		if (write_block() != 0) {
+			LOG_WRN("Journal write failed, %u records lost", records_lost);
+		}
+		/* write_block() always leaves an empty block, and a keyframe fits
+		 * in one (static_assert above), so this is the only retry.
+		 */
+		n = encode_record(rec, true, tmp);
+	}
+ 
+	memcpy(&block[block_len], tmp, n);
+	block_len += n;
+	prev_rec = *rec;
+	block_records++;
+	records_total++;
+}
+ 
+static void sample(Record *rec)
+{
+	monitor::collect_top_snapshot(&journal_snap, &journal_tracker);
+ 
+	int64_t epoch = 0;
+ 
+	if (journal_snap.rtc_ok) {
+		epoch = timeutil_timegm64(rtc_time_to_tm(&journal_snap.rtc_now));
+	}
+ 
+	rec->f[0] = journal_snap.uptime_s;
+	rec->f[1] = epoch;
+	rec->f[2] = journal_snap.load_permille;
+	rec->f[3] = journal_snap.heap_ok ? journal_snap.heap_stats.allocated_bytes : 0;
+	rec->f[4] = journal_snap.min_free_stack;
+	rec->f[5] = LvglDemo::instance().fps();
+}
+ 
+static void journal_worker(void *p1, void *p2, void *p3)
+{
+	Record rec;
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+ 
+	while (true) {
+		k_sleep(K_SECONDS(CONFIG_APP_JOURNAL_PERIOD_S));
+		sample(&rec);
+		k_mutex_lock(&journal_lock, K_FOREVER);
+		append_record(&rec);
+		k_mutex_unlock(&journal_lock);
+	}
+}
+ 
+int journal_start()
+{
+	const struct device *dev;
+	struct flash_pages_info info;
+	int rc;
+ 
+	rc = flash_area_open(FIXED_PARTITION_ID(journal_partition), &fa);
+	if (rc != 0) {
+		LOG_ERR("journal_partition open failed: %d", rc);
+		return rc;
+	}
+ 
+	dev = flash_area_get_device(fa);
+	rc = flash_get_page_info_by_offs(dev, fa->fa_off, &info);
+	if (rc != 0) {
+		return rc;
+	}
+	sector_size = info.size;
+	sector_count = fa->fa_size / sector_size;
+	if ((sector_count < 2U) || ((kBlockSize % flash_area_align(fa)) != 0U)) {
+		LOG_ERR("journal_partition needs >= 2 sectors and %u-aligned blocks",
+			(unsigned int)flash_area_align(fa));
+		return -EINVAL;
+	}
+ 
+	rc = scan();
+	if (rc != 0) {
+		LOG_ERR("Journal scan failed: %d", rc);
+		return rc;
+	}
+	boot_no++;
+	block_len = kBlockHdrSize;
+	journal_ready = true;
+ 
+	k_thread_create(&journal_thread, journal_stack, K_THREAD_STACK_SIZEOF(journal_stack),
+			journal_worker, nullptr, nullptr, nullptr, JOURNAL_PRIO, 0, K_NO_WAIT);
+	k_thread_name_set(&journal_thread, "journal");
+	LOG_INF("Journal boot #%u, sector %u seq %u", boot_no, cur_sector, cur_seq);
+	return 0;
+}
+ 
+static void dump_block(const struct shell *sh, uint32_t off)
+{
+	uint8_t buf[32];
+	char line[2 * sizeof(buf) + 1];
+ 
+	shell_print(sh, "B %08x", off);
+	for (uint32_t pos = 0; pos < kBlockSize; pos += sizeof(buf)) {
+		if (flash_area_read(fa, off + pos, buf, sizeof(buf)) != 0) {
+			shell_error(sh, "read failed at %08x", off + pos);
+			return;
+		}
+		for (uint32_t i = 0; i < sizeof(buf); ++i) {
+			static const char hex[] = "0123456789abcdef";
+ 
+			line[2 * i] = hex[buf[i] >> 4];
+			line[2 * i + 1] = hex[buf[i] & 0x0FU];
+		}
+		line[sizeof(line) - 1] = '\0';
+		shell_print(sh, "D %s", line);
+	}
+}
+ 
+static int cmd_journal_dump(const struct shell *sh, size_t argc, char **argv)
+{
+	SectorHeader hdr;
+	uint8_t head[2];
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+ 
+	if (!journal_ready) {
+		shell_error(sh, "journal is not available");
+		return -ENODEV;
+	}
+ 
+	k_mutex_lock(&journal_lock, K_FOREVER);
+	shell_print(sh, "J v%u block=%u", kVersion, kBlockSize);
+	/* Oldest first: the sector after the current one is the oldest one still valid. */
+	for (uint32_t i = 1; i <= sector_count; ++i) {
+		uint32_t s = (cur_sector + i) % sector_count;
+ 
+		if (!read_sector_header(s, &hdr)) {
+			continue;
+		}
+		for (uint32_t off = sector_off(s) + kBlockSize; off < sector_off(s + 1U);
+		     off += kBlockSize) {
+			bool erased;
+ 
+			if (flash_area_read(fa, off, head, sizeof(head)) != 0) {
+				break;
+			}
+			if (sys_get_le16(head) == kBlockMagic) {
+				dump_block(sh, off);
+				continue;
+			}
+			/* Like scan(): a torn block is skipped, erased flash ends the sector. */
+			if ((block_erased(off, &erased) != 0) || erased) {
+				break;
+			}
+			shell_print(sh, "# corrupt block at 0x%x", off);
+		}
+	}
+	if (block_len > kBlockHdrSize) {
+		shell_print(sh, "# %u records pending in RAM, 'journal flush' to persist",
+			    block_records);
+	}
+	shell_print(sh, "J end");
+	k_mutex_unlock(&journal_lock);
+	return 0;
+}
+ 
+static int cmd_journal_flush(const struct shell *sh, size_t argc, char **argv)
+{
+	int rc;
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+ 
+	if (!journal_ready) {
+		shell_error(sh, "journal is not available");
+		return -ENODEV;
+	}
+ 
+	k_mutex_lock(&journal_lock, K_FOREVER);
+	rc = write_block();
+	k_mutex_unlock(&journal_lock);
+	if (rc != 0) {
+		shell_error(sh, "flush failed: %d", rc);
+		return rc;
+	}
+	shell_print(sh, "journal flushed");
+	return 0;
+}
+ 
+static int cmd_journal_stats(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+ 
+	if (!journal_ready) {
+		shell_error(sh, "journal is not available");
+		return -ENODEV;
+	}
+ 
+	shell_print(sh, "boot=%u sectors=%ux%uKB current=%u seq=%u write_off=0x%x", boot_no,
+		    sector_count, sector_size / 1024U, cur_sector, cur_seq, write_off);
+	shell_print(sh, "records=%u blocks_written=%u sectors_erased=%u ram_block=%u/%uB",
+		    records_total, blocks_written, sectors_erased, block_len, kBlockSize);
+	shell_print(sh, "write_errors=%u records_lost=%u", write_errors, records_lost);
+	return 0;
+}
+ 
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_journal,
+	SHELL_CMD(dump, NULL, "Dump journal blocks (decode with scripts/journal_decode.py)",
+		  cmd_journal_dump),
+	SHELL_CMD(flush, NULL, "Write the pending RAM block to flash", cmd_journal_flush),
+	SHELL_CMD(stats, NULL, "Show journal state", cmd_journal_stats),
+	SHELL_SUBCMD_SET_END
+);
+SHELL_CMD_REGISTER(journal, &sub_journal, "Flash telemetry journal", NULL);
@@ -0,0 +1,3 @@
+#pragma once
+ 
+int journal_start();
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include "monitor/log_stats.hpp"
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/logging/log_ctrl.h>
+#include <zephyr/shell/shell.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cstdint>
+ 
+#define LOG_BENCH_STACK_SIZE 1024
+#define LOG_BENCH_MAX_THREADS 3
+#define LOG_BENCH_DEFAULT_MSGS 500
+#define LOG_BENCH_DRAIN_TIMEOUT_MS 5000
+ 
+LOG_MODULE_REGISTER(log_bench, LOG_LEVEL_INF);
+ 
+/* One flooder per priority: above, between and below the app threads. */
+static const int bench_prio[LOG_BENCH_MAX_THREADS] = {4, 7, 10};
+ 
+K_THREAD_STACK_ARRAY_DEFINE(bench_stacks, LOG_BENCH_MAX_THREADS, LOG_BENCH_STACK_SIZE);
+static struct k_thread bench_threads[LOG_BENCH_MAX_THREADS];
+static bool bench_running;
+ 
+struct log_thread_probe {
+	k_tid_t tid;
+	uint64_t cycles;
+};
+ 
+static void flooder(void *p1, void *p2, void *p3)
+{
+	auto id = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(p1));
+	auto count = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(p2));
+	ARG_UNUSED(p3);
+ 
+	for (uint32_t seq = 0; seq < count; ++seq) {
+		if ((seq & 1U) == 0U) {
+			LOG_INF("bench t%u seq %u", id, seq);
+		} else {
+			LOG_WRN("bench t%u seq %u", id, seq);
+		}
+	}
+}
+ 
+static void find_log_thread(const struct k_thread *thread, void *user_data)
+{
+	auto *probe = static_cast<struct log_thread_probe *>(user_data);
+	const char *name = k_thread_name_get((k_tid_t)thread);
+	k_thread_runtime_stats_t rt = {0};
+ 
+	if ((name == nullptr) || (strcmp(name, "logging") != 0)) {
+		return;
+	}
+	if (k_thread_runtime_stats_get((k_tid_t)thread, &rt) == 0) {
+		probe->tid = (k_tid_t)thread;
+		probe->cycles = rt.total_cycles;
+	}
+}
+ 
+static bool parse_u32(const char *text, uint32_t min, uint32_t max, uint32_t *out)
+{
+	char *end = nullptr;
+	unsigned long value = strtoul(text, &end, 10);
+ 
+	if ((end == text) || (*end != '\0') || (value < min) || (value > max)) {
+		return false;
+	}
+	*out = static_cast<uint32_t>(value);
+	return true;
+}
+ 
+static int cmd_logbench_run(const struct shell *sh, size_t argc, char **argv)
+{
+	uint32_t msgs = LOG_BENCH_DEFAULT_MSGS;
+	uint32_t threads = LOG_BENCH_MAX_THREADS;
+	monitor::LogStats before = {};
+	monitor::LogStats after = {};
+	struct log_thread_probe log_before = {};
+	struct log_thread_probe log_after = {};
+ 
+	if ((argc > 1) && !parse_u32(argv[1], 1, 100000, &msgs)) {
+		shell_error(sh, "Usage: logbench run [msgs_per_thread] [threads 1..%d]",
+			    LOG_BENCH_MAX_THREADS);
+		return -EINVAL;
+	}
+	if ((argc > 2) && !parse_u32(argv[2], 1, LOG_BENCH_MAX_THREADS, &threads)) {
+		shell_error(sh, "threads must be 1..%d", LOG_BENCH_MAX_THREADS);
+		return -EINVAL;
+	}
+	if (bench_running) {
+		shell_warn(sh, "logbench already running");
+		return -EBUSY;
+	}
+	bench_running = true;
+ 
+	monitor::log_stats_reset_latency();
+	monitor::log_stats_get(&before);
+	k_thread_foreach(find_log_thread, &log_before);
+	const int64_t started_ms = k_uptime_get();
+ 
+	for (uint32_t i = 0; i < threads; ++i) {
+		k_thread_create(&bench_threads[i], bench_stacks[i],
+				K_THREAD_STACK_SIZEOF(bench_stacks[i]), flooder,
+				reinterpret_cast<void *>(static_cast<uintptr_t>(i)),
+				reinterpret_cast<void *>(static_cast<uintptr_t>(msgs)), nullptr,
+				bench_prio[i], 0, K_NO_WAIT);
+		k_thread_name_set(&bench_threads[i], "log_bench");
+	}
+	for (uint32_t i = 0; i < threads; ++i) {
+		(void)k_thread_join(&bench_threads[i], K_FOREVER);
+	}
+	const int64_t produced_ms = k_uptime_get();
+ 
+	while (log_data_pending() && ((k_uptime_get() - produced_ms) < LOG_BENCH_DRAIN_TIMEOUT_MS)) {
+		k_msleep(1);
+	}
+	const int64_t drained_ms = k_uptime_get();
+ 
+	monitor::log_stats_get(&after);
+	k_thread_foreach(find_log_thread, &log_after);
+	bench_running = false;
+ 
+	const uint32_t produced = msgs * threads;
+	const uint32_t processed = after.processed - before.processed;
+	const uint32_t dropped = after.dropped - before.dropped;
+	const auto elapsed_ms = static_cast<uint32_t>(MAX(drained_ms - started_ms, 1));
+	const uint64_t elapsed_cyc = k_ms_to_cyc_floor64(elapsed_ms);
+	const uint64_t log_cyc = log_after.cycles - log_before.cycles;
+	const uint32_t log_permille = (elapsed_cyc > 0U)
+		? static_cast<uint32_t>((log_cyc * 1000U) / elapsed_cyc)
+		: 0U;
+	const uint32_t lat_avg_us = (after.latency_samples > 0U)
+		? static_cast<uint32_t>(after.latency_sum_us / after.latency_samples)
+		: 0U;
+ 
+	shell_print(sh, "produced   : %u msgs (%u threads x %u)", produced, threads, msgs);
+	shell_print(sh, "processed  : %u msgs in %u ms -> %u msg/s", processed, elapsed_ms,
+		    (processed * 1000U) / elapsed_ms);
+	shell_print(sh, "produce    : %u ms -> %u msg/s offered",
+		    static_cast<uint32_t>(produced_ms - started_ms),
+		    (produced * 1000U) / static_cast<uint32_t>(MAX(produced_ms - started_ms, 1)));
+	shell_print(sh, "dropped    : %u", dropped);
+	if (after.buf_ok) {
+		shell_print(sh, "buffer     : %u B, high-water %u B", after.buf_size, after.buf_peak);
+	} else {
+		shell_print(sh, "buffer     : n/a (CONFIG_LOG_MEM_UTILIZATION)");
+	}
+	shell_print(sh, "latency    : avg %u us, max %u us", lat_avg_us,
+		    after.latency_max_us);
+	if (log_after.tid != nullptr) {
+		shell_print(sh, "log thread : %u.%u%% CPU", log_permille / 10U, log_permille % 10U);
+	} else {
+		shell_print(sh, "log thread : n/a");
+	}
+	if (log_data_pending()) {
+		shell_warn(sh, "log backlog not drained within %d ms", LOG_BENCH_DRAIN_TIMEOUT_MS);
+	}
+	return 0;
+}
+ 
+static int cmd_logbench_stats(const struct shell *sh, size_t argc, char **argv)
+{
+	monitor::LogStats stats = {};
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+ 
+	monitor::log_stats_get(&stats);
+	shell_print(sh, "processed=%u dropped=%u", stats.processed, stats.dropped);
+	if (stats.buf_ok) {
+		shell_print(sh, "buffer used=%u/%uB peak=%uB", stats.buf_used, stats.buf_size,
+			    stats.buf_peak);
+	}
+	return 0;
+}
+ 
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_logbench,
+	SHELL_CMD(run, NULL, "Flood logger: run [msgs_per_thread] [threads]", cmd_logbench_run),
+	SHELL_CMD(stats, NULL, "Show log processed/dropped counters", cmd_logbench_stats),
+	SHELL_SUBCMD_SET_END
+);
+SHELL_CMD_REGISTER(logbench, &sub_logbench, "Log pipeline benchmark", NULL);
@@ -16,12 +16,88 @@
 #include <errno.h>
 #include <string.h>
 #include "ui.h"
+#if defined(CONFIG_APP_UI_IMAGES)
+#include "ui_img_assets.h"
+#endif
 #include "rtc_service.hpp"
+#include "monitor/flush_stats.hpp"
+#include "monitor/fmt.hpp"
+#include "monitor/lvgl_mem.hpp"
+#include "display/digit_sprites.hpp"
+#include "display/disp_io.hpp"
+#include "display/draw_buffers.hpp"
+#include "display/font_subset.h"
+#include "display/refr_governor.hpp"
 
 LOG_MODULE_REGISTER(lvgl_demo, LOG_LEVEL_INF);
 
+/* Период обновления виджетов. */
+static constexpr int64_t kUpdatePeriodMs = 500;
+
+/* ---- применение значений к виджетам --------------------------------------- */
+
+/* Текст числовой метки: спрайты цифр или обычный lv_label. Текст должен
+ * жить дольше метки: lv_label_set_text_static хранит указатель, а не копию,
+ * поэтому обновление не трогает кучу LVGL. Спрайтовая метка копирует текст
+ * в свой буфер сама. */
+static void set_numeric_text(lv_obj_t *obj, const char *text)
+{
+#if defined(CONFIG_APP_DIGIT_SPRITES)
+    display::sprite_label_set_text(obj, text);
+#else
+    lv_label_set_text_static(obj, text);
+#endif
+}
+
+static void apply_arc(lv_obj_t *obj, int32_t pct)
+{
+    lv_arc_set_value(obj, pct);
+}
+
+/* У каждой метки свой статический буфер (см. set_numeric_text), числа
+ * форматируются monitor::fmt без snprintf. */
+static void apply_cpu(lv_obj_t *obj, int32_t pct)
+{
+    static char buf[8];
+    size_t n = monitor::fmt::i32(buf, pct);
+    buf[n++] = '%';
+    buf[n] = '\0';
+    set_numeric_text(obj, buf);
+}
+
+static void apply_hhmm(lv_obj_t *obj, int32_t minutes)
+{
+    static char buf[8];
+    if (minutes < 0) {
+        set_numeric_text(obj, "--:--");
+        return;
+    }
+    monitor::fmt::zero2(&buf[0], static_cast<uint32_t>(minutes / 60));
+    buf[2] = ':';
+    monitor::fmt::zero2(&buf[3], static_cast<uint32_t>(minutes % 60));
+    buf[5] = '\0';
+    set_numeric_text(obj, buf);
+}
+
+static void apply_sec(lv_obj_t *obj, int32_t sec)
+{
+    static char buf[4];
+    if (sec < 0) {
+        set_numeric_text(obj, "--");
+        return;
+    }
+    monitor::fmt::zero2(&buf[0], static_cast<uint32_t>(sec));
+    buf[2] = '\0';
+    set_numeric_text(obj, buf);
+}
+
 /* ---- синглтон ------------------------------------------------------------ */
 
+LvglDemo::LvglDemo()
+    : arc_(apply_arc), cpu_label_(apply_cpu), hhmm_label_(apply_hhmm), sec_label_(apply_sec)
+{
+}
+
 LvglDemo &LvglDemo::instance()
 {
     static LvglDemo inst;
@@ -36,21 +112,55 @@ void LvglDemo::setup_widgets()
     lv_obj_set_style_bg_color(ui_Screen1, lv_color_hex(bg_color_), LV_STATE_DEFAULT);
     lv_obj_set_style_bg_opa(ui_Screen1, LV_OPA_COVER, LV_STATE_DEFAULT);
 
+#if defined(CONFIG_APP_UI_IMAGES)
+    /* Картинка из flash (scripts/png2lvimg.py): в SLS у ui_Image1 нет
+     * источника. Позицию SLS (за пределами экрана 128x128) не трогаем:
+     * ручка 77x70 по центру легла бы под числовые метки, а спрайты цифр —
+     * непрозрачные плитки цвета фона экрана, они прорезали бы в ней дыры,
+     * и каждое обновление метки смешивалось бы с картинкой. */
+    lv_image_set_src(ui_Image1, &ui_img_pot_hor_knob_png);
+#endif
+
     /* Диапазон дуги: 0..100 (проценты CPU). */
     lv_arc_set_range(ui_Arc1, 0, 100);
-    lv_arc_set_value(ui_Arc1, 0);
 
-    /* Начальные значения виджетов. */
-    lv_label_set_text(ui_lCpu,  "--%");
-    lv_label_set_text(ui_lTime, "--:--");
-    lv_label_set_text(ui_timel, "--");
+    /* Числовые метки рисуются готовыми спрайтами цифр (тот же шрифт,
+     * цвет и место, что у SLS-меток; сами метки скрываются). */
+    lv_obj_t *cpu  = ui_lCpu;
+    lv_obj_t *hhmm = ui_lTime;
+    lv_obj_t *sec  = ui_timel;
+#if defined(CONFIG_APP_FONT_SUBSET)
+    /* Шрифт-подмножество из сборки: только глифы, которые реально
+     * встречаются в метках (scripts/font_subset.py). */
+    lv_obj_set_style_text_font(cpu, app_font_subset, LV_PART_MAIN);
+    lv_obj_set_style_text_font(hhmm, app_font_subset, LV_PART_MAIN);
+    lv_obj_set_style_text_font(sec, app_font_subset, LV_PART_MAIN);
+#endif
+#if defined(CONFIG_APP_DIGIT_SPRITES)
+    cpu  = display::sprite_label_replace(cpu);
+    hhmm = display::sprite_label_replace(hhmm);
+    sec  = display::sprite_label_replace(sec);
+#endif
+
+    /* Начальные значения виджетов — через привязки, чтобы кэш совпадал
+     * с экраном. Метка CPU до первого замера показывает «--%». */
+    set_numeric_text(cpu, "--%");
+    cpu_label_.bind(cpu);
+    arc_.bind(ui_Arc1);
+    (void)arc_.set(0);
+    hhmm_label_.bind(hhmm);
+    (void)hhmm_label_.set(-1);
+    sec_label_.bind(sec);
+    (void)sec_label_.set(-1);
 }
 
 /* ---- private: замер CPU -------------------------------------------------- */
 
 uint8_t LvglDemo::sample_cpu()
 {
-    int32_t raw = cpu_load_get(false);
+    /* Сброс окна: загрузка считается за последние 500 мс, а не с момента
+     * загрузки (top считает свою загрузку по собственным счётчикам циклов). */
+    int32_t raw = cpu_load_get(true);
     if (raw < 0) {
         raw = 0;
     }
@@ -60,77 +170,176 @@ uint8_t LvglDemo::sample_cpu()
 
 /* ---- private: обновление виджетов ---------------------------------------- */
 
-void LvglDemo::update_widgets(uint8_t cpu_pct, uint16_t fps)
+void LvglDemo::update_widgets(uint8_t cpu_pct)
 {
-    ARG_UNUSED(fps);
-
-    /* Читаем время из RTC до захвата мьютекса LVGL. */
     struct rtc_time t = {};
     const bool has_time = rtc_service_get(&t);
 
-    char cpu_buf[8];
-    (void)snprintf(cpu_buf, sizeof(cpu_buf), "%u%%",
-        static_cast<unsigned>(cpu_pct));
+    /* Без lvgl_lock: значения уходят в mailbox_ и применяются в потоке
+     * LVGL перед ближайшим кадром. */
+    post(kArc, cpu_pct);
+    post(kCpu, cpu_pct);
+    post(kHhmm, has_time ? (t.tm_hour * 60 + t.tm_min) : -1);
+    post(kSec, has_time ? t.tm_sec : -1);
+}
+
+/* ---- private: очередь обновлений ----------------------------------------- */
 
-    char hhmm_buf[8];
-    char sec_buf[4];
-    if (has_time) {
-        (void)snprintf(hhmm_buf, sizeof(hhmm_buf), "%02d:%02d",
-            t.tm_hour, t.tm_min);
-        (void)snprintf(sec_buf, sizeof(sec_buf), "%02d", t.tm_sec);
-    } else {
-        (void)snprintf(hhmm_buf, sizeof(hhmm_buf), "--:--");
-        (void)snprintf(sec_buf,  sizeof(sec_buf),  "--");
+void LvglDemo::post(WidgetId id, int32_t value)
+{
+    mailbox_.post(id, value);
+    if (!ready_) {
+        return;   /* до init() всё применит setup_widgets/первый кадр */
     }
+    /* k_work_submit неблокирующий; уже стоящая в очереди работа не
+     * дублируется — несколько post() подряд дают один разбор. */
+#if defined(CONFIG_LV_Z_RUN_LVGL_ON_WORKQUEUE)
+    (void)k_work_submit_to_queue(lvgl_get_workqueue(), &drain_work_);
+#else
+    (void)k_work_submit(&drain_work_);
+#endif
+}
+
+void LvglDemo::apply_pending()
+{
+    /* Каждый set() — сравнение с кэшем; LVGL (и инвалидация области)
+     * только если значение изменилось. Обычно меняются лишь секунды. */
+    (void)mailbox_.drain([this](uint32_t id, int32_t value) {
+        switch (id) {
+        case kArc:  (void)arc_.set(value);        break;
+        case kCpu:  (void)cpu_label_.set(value);  break;
+        case kHhmm: (void)hhmm_label_.set(value); break;
+        case kSec:  (void)sec_label_.set(value);  break;
+        case kBg:
+            lv_obj_set_style_bg_color(ui_Screen1, lv_color_hex(static_cast<uint32_t>(value)),
+                LV_STATE_DEFAULT);
+            lv_obj_set_style_bg_opa(ui_Screen1, LV_OPA_COVER, LV_STATE_DEFAULT);
+#if defined(CONFIG_APP_DIGIT_SPRITES)
+            /* Спрайты отрисованы на старом фоне — перерисовать тайлы. */
+            display::digit_sprites_refresh();
+#endif
+            break;
+        default:
+            break;
+        }
+    });
+}
 
+void LvglDemo::drain_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+    /* На workqueue LVGL мьютекс свободен: рендер идёт в том же потоке. */
     lvgl_lock();
-    lv_arc_set_value(ui_Arc1,  cpu_pct);
-    lv_label_set_text(ui_lCpu,  cpu_buf);
-    lv_label_set_text(ui_lTime, hhmm_buf);
-    lv_label_set_text(ui_timel, sec_buf);
+    instance().apply_pending();
+#if defined(CONFIG_APP_REFR_GOVERNOR)
+    /* Регулятор мог быть в idle: рисуем сразу, а не через период idle. */
+    display::refr_governor_service();
+#endif
     lvgl_unlock();
 }
 
+void LvglDemo::refr_start_cb(lv_event_t *e)
+{
+    ARG_UNUSED(e);
+    /* Перед рендером кадра: всё, что пришло к этому моменту, попадёт в кадр. */
+    instance().apply_pending();
+}
+
 /* ---- public: init --------------------------------------------------------- */
 
 void LvglDemo::init()
 {
     const struct device *disp = DEVICE_DT_GET(DT_CHOSEN(zephyr_display));
+#if defined(CONFIG_APP_DISP_IO)
+    /* Дисплей и LVGL поднимаются из disp_io (non-cacheable стек для DMA). */
+    if (display::disp_io_start() != 0) {
+        LOG_WRN("disp_io start failed");
+        return;
+    }
+#endif
     if (!device_is_ready(disp)) {
         LOG_WRN("Display device is not ready");
         return;
     }
 
     lvgl_lock();
+#if defined(CONFIG_APP_LVGL_PINGPONG)
+    /* Ping-pong буферы в SRAM1/SRAM2 вместо буферов glue. */
+    display::draw_buffers_attach(lv_display_get_default());
+#endif
+    /* Сколько пула LVGL стоит построение экрана (объекты + локальные
+     * стили): сравнивать с CONFIG_APP_UI_CONST_STYLES=y/n. */
+    lv_mem_monitor_t mon_before;
+    lv_mem_monitor_t mon_after;
+    lv_mem_monitor(&mon_before);
     ui_init();
+    lv_mem_monitor(&mon_after);
+    ui_pool_bytes_ = (mon_before.free_size > mon_after.free_size)
+        ? static_cast<uint32_t>(mon_before.free_size - mon_after.free_size) : 0U;
     setup_widgets();
+    monitor::flush_stats_attach(lv_display_get_default());
+    /* Обновления из mailbox_ применяются в начале каждого кадра. */
+    lv_display_add_event_cb(lv_display_get_default(), refr_start_cb,
+        LV_EVENT_REFR_START, nullptr);
+#if defined(CONFIG_APP_REFR_GOVERNOR)
+    /* Статичный экран — редкий опрос, при изменениях — LV_DEF_REFR_PERIOD. */
+    display::refr_governor_attach(lv_display_get_default());
+#endif
     lvgl_unlock();
 
+#if defined(CONFIG_APP_DISP_IO)
+    (void)display::disp_io_blanking_off();
+#else
     (void)display_blanking_off(disp);
+#endif
+    k_work_init(&drain_work_, drain_handler);
     ready_ = true;
+
+    /* Обновления — по дедлайнам на LVGL workqueue, без опроса из main. */
+    k_work_init_delayable(&update_work_, update_handler);
+    next_update_ms_ = k_uptime_get();
+    schedule_next();
     LOG_INF("LVGL demo initialized");
 }
 
-/* ---- public: tick --------------------------------------------------------- */
+/* ---- private: периодическое обновление ---------------------------------- */
 
-void LvglDemo::tick(uint32_t tick_ms)
+void LvglDemo::schedule_next()
 {
-    if (!ready_) {
-        return;
+    /* Дедлайны абсолютные (uptime), поэтому каденция не дрейфует; если
+     * обработчик опоздал больше чем на период — пропускаем, а не догоняем. */
+    next_update_ms_ += kUpdatePeriodMs;
+    const int64_t now = k_uptime_get();
+    while (next_update_ms_ <= now) {
+        next_update_ms_ += kUpdatePeriodMs;
     }
 
-    fps_count_++;
+#if defined(CONFIG_LV_Z_RUN_LVGL_ON_WORKQUEUE)
+    /* Прямо в поток LVGL: обновление не конкурирует с рендером за мьютекс. */
+    (void)k_work_schedule_for_queue(lvgl_get_workqueue(), &update_work_,
+        K_TIMEOUT_ABS_MS(next_update_ms_));
+#else
+    (void)k_work_schedule(&update_work_, K_TIMEOUT_ABS_MS(next_update_ms_));
+#endif
+}
 
-    /* Обновляем виджеты раз в 500 мс. */
-    if ((tick_ms - fps_last_ms_) < 500U) {
-        return;
+void LvglDemo::update_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+    LvglDemo &self = instance();
+
+    const int64_t late = k_uptime_get() - self.next_update_ms_;
+    if (late > static_cast<int64_t>(self.update_late_max_ms_)) {
+        self.update_late_max_ms_ = static_cast<uint32_t>(late);
     }
-    fps_current_  = static_cast<uint16_t>(fps_count_ * 2U);  /* *2 т.к. 500 мс */
-    fps_count_    = 0;
-    fps_last_ms_  = tick_ms;
 
-    const uint8_t cpu_pct = sample_cpu();
-    update_widgets(cpu_pct, fps_current_);
+    /* FPS — реально отрисованные кадры (monitor/flush_stats). */
+    self.fps_current_ = static_cast<uint16_t>(monitor::flush_stats_fps());
+    const uint8_t cpu_pct = self.sample_cpu();
+    self.update_widgets(cpu_pct);
+    /* Пик пула LVGL: каждый новый пик пишется в лог. */
+    monitor::lvgl_mem_poll();
+    self.schedule_next();
 }
 
 /* ---- public: set_bg_color ------------------------------------------------- */
@@ -138,13 +347,7 @@ void LvglDemo::tick(uint32_t tick_ms)
 void LvglDemo::set_bg_color(uint32_t rgb_hex)
 {
     bg_color_ = rgb_hex;
-    if (!ready_) {
-        return;
-    }
-    lvgl_lock();
-    lv_obj_set_style_bg_color(ui_Screen1, lv_color_hex(rgb_hex), LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui_Screen1, LV_OPA_COVER, LV_STATE_DEFAULT);
-    lvgl_unlock();
+    post(kBg, static_cast<int32_t>(rgb_hex));
 }
 
 /* ---- public: print_stats -------------------------------------------------- */
@@ -157,12 +360,85 @@ void LvglDemo::print_stats(const struct shell *sh) const
         static_cast<unsigned>(cpu_permille_ % 10U));
     shell_print(sh, "fps        : %u",   static_cast<unsigned>(fps_current_));
     shell_print(sh, "bg_color   : #%06x", static_cast<unsigned>(bg_color_));
+    shell_print(sh, "update     : каждые %d мс, макс. опоздание %u мс",
+        static_cast<int>(kUpdatePeriodMs), static_cast<unsigned>(update_late_max_ms_));
+#if defined(CONFIG_APP_REFR_GOVERNOR)
+    display::GovernorStats gov;
+    display::refr_governor_get(&gov);
+    shell_print(sh, "refr       : %s, период %u мс; active %u с, idle %u с, пробуждений %u",
+        gov.idle ? "idle" : "active", static_cast<unsigned>(gov.period_ms),
+        static_cast<unsigned>(gov.active_ms / 1000U), static_cast<unsigned>(gov.idle_ms / 1000U),
+        static_cast<unsigned>(gov.wakeups));
+#endif
+    shell_print(sh, "ui pool    : %u B после ui_init (const-стили %s)",
+        static_cast<unsigned>(ui_pool_bytes_),
+        IS_ENABLED(CONFIG_APP_UI_CONST_STYLES) ? "вкл" : "выкл");
+    shell_print(sh, "mailbox    : отправлено %u, применено %u (схлопнуто %u)",
+        static_cast<unsigned>(mailbox_.posted()), static_cast<unsigned>(mailbox_.drained()),
+        static_cast<unsigned>(mailbox_.posted() - mailbox_.drained()));
+    shell_print(sh, "widgets    : обновлено %u, пропущено без изменений %u",
+        static_cast<unsigned>(arc_.applied() + cpu_label_.applied() +
+                              hhmm_label_.applied() + sec_label_.applied()),
+        static_cast<unsigned>(arc_.skipped() + cpu_label_.skipped() +
+                              hhmm_label_.skipped() + sec_label_.skipped()));
+
+    /* SPI-трафик: частичный рефреш шлёт только изменённые области. */
+    monitor::FlushStats fs;
+    monitor::flush_stats_get(&fs);
+    const uint32_t avg = (fs.frames > 0U)
+        ? static_cast<uint32_t>(fs.bytes / fs.frames) : 0U;
+    shell_print(sh, "frames     : %u (areas %u)",
+        static_cast<unsigned>(fs.frames), static_cast<unsigned>(fs.areas));
+    shell_print(sh, "bytes/frame: last %u (%u areas), avg %u, max %u, full %u",
+        static_cast<unsigned>(fs.last_frame_bytes),
+        static_cast<unsigned>(fs.last_frame_areas),
+        static_cast<unsigned>(avg),
+        static_cast<unsigned>(fs.max_frame_bytes),
+        static_cast<unsigned>(fs.full_frame_bytes));
+
+    /* Тайминг последних kFrameWindow кадров: min/avg/max в мкс. */
+    monitor::FrameTiming ft;
+    monitor::flush_stats_timing(&ft);
+    shell_print(sh, "window     : %u frames", static_cast<unsigned>(ft.samples));
+    shell_print(sh, "frame us   : %u/%u/%u", static_cast<unsigned>(ft.frame_us.min),
+        static_cast<unsigned>(ft.frame_us.avg), static_cast<unsigned>(ft.frame_us.max));
+    shell_print(sh, "render us  : %u/%u/%u", static_cast<unsigned>(ft.render_us.min),
+        static_cast<unsigned>(ft.render_us.avg), static_cast<unsigned>(ft.render_us.max));
+    shell_print(sh, "flush us   : %u/%u/%u (на область)", static_cast<unsigned>(ft.flush_us.min),
+        static_cast<unsigned>(ft.flush_us.avg), static_cast<unsigned>(ft.flush_us.max));
+#if defined(CONFIG_APP_DISP_IO)
+    /* Flush асинхронный: LVGL ждёт только когда нужен буфер в передаче. */
+    display::DispIoStats io;
+    display::disp_io_get_stats(&io);
+    shell_print(sh, "flush wait : %u раз, avg %u us, max %u us; записей %u/%u, не по порядку %u",
+        static_cast<unsigned>(io.waits),
+        (io.waits > 0U) ? static_cast<unsigned>(k_cyc_to_us_floor64(io.wait_cyc / io.waits)) : 0U,
+        static_cast<unsigned>(k_cyc_to_us_floor32(io.wait_cyc_max)),
+        static_cast<unsigned>(io.completed), static_cast<unsigned>(io.submitted),
+        static_cast<unsigned>(io.out_of_order));
+#endif
+    shell_print(sh, "pixels     : %u/%u/%u", static_cast<unsigned>(ft.pixels.min),
+        static_cast<unsigned>(ft.pixels.avg), static_cast<unsigned>(ft.pixels.max));
+
+    char hist_buf[128];
+    int pos = 0;
+    for (uint32_t i = 0; i < monitor::kFrameHistBuckets; ++i) {
+        const bool last = (i == (monitor::kFrameHistBuckets - 1U));
+        pos += snprintf(&hist_buf[pos], sizeof(hist_buf) - pos, "%s%u:%u ",
+            last ? ">=" : "<",
+            static_cast<unsigned>(last ? monitor::kFrameHistLimitsMs[i - 1U]
+                                       : monitor::kFrameHistLimitsMs[i]),
+            static_cast<unsigned>(ft.hist[i]));
+        if (pos >= static_cast<int>(sizeof(hist_buf))) {
+            break;
+        }
+    }
+    shell_print(sh, "hist ms    : %s", hist_buf);
 }
 
 /* ---- C API --------------------------------------------------------------- */
 
 void lvgl_demo_init()               { LvglDemo::instance().init(); }
-void lvgl_demo_tick(uint32_t ms)    { LvglDemo::instance().tick(ms); }
 
 /* ---- Shell: oled bg RRGGBB / oled info ----------------------------------- */
 
@@ -194,9 +470,159 @@ static int cmd_oled_info(const struct shell *sh, size_t argc, char **argv)
     return 0;
 }
 
+/* Пул LVGL (lv_mem_monitor) и рекомендуемый CONFIG_LV_Z_MEM_POOL_SIZE:
+ * пик + kLvglMemHeadroomPct%. Пик копится с загрузки, поэтому смотреть
+ * после прогона всех экранов и режимов. */
+static int cmd_oled_mem(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    monitor::LvglMemStats m;
+    monitor::lvgl_mem_poll(&m);
+    shell_print(sh, "pool       : %u B, занято %u B (%u%%), свободно %u B, блоков %u",
+        static_cast<unsigned>(m.total), static_cast<unsigned>(m.used),
+        static_cast<unsigned>(m.used_pct), static_cast<unsigned>(m.free),
+        static_cast<unsigned>(m.used_cnt));
+    if (m.biggest_free > 0U) {
+        shell_print(sh, "free block : макс. %u B, фрагментация %u%%",
+            static_cast<unsigned>(m.biggest_free), static_cast<unsigned>(m.frag_pct));
+    } else {
+        shell_print(sh, "free block : аллокатор не сообщает");
+    }
+    shell_print(sh, "peak       : %u B", static_cast<unsigned>(m.peak));
+    shell_print(sh, "рекомендуем: CONFIG_LV_Z_MEM_POOL_SIZE=%u (пик + %u%%), сейчас %u, "
+        "освободится %d B",
+        static_cast<unsigned>(m.recommended), static_cast<unsigned>(monitor::kLvglMemHeadroomPct),
+        static_cast<unsigned>(CONFIG_LV_Z_MEM_POOL_SIZE),
+        static_cast<int>(CONFIG_LV_Z_MEM_POOL_SIZE) - static_cast<int>(m.recommended));
+    return 0;
+}
+
+static int cmd_oled_reset(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+    monitor::flush_stats_reset();
+    shell_print(sh, "Статистика кадров сброшена");
+    return 0;
+}
+
+#if defined(CONFIG_APP_DISP_IO)
+static int cmd_oled_flushcheck(const struct shell *sh, size_t argc, char **argv)
+{
+    uint32_t writes = 8U;
+    if (argc == 2) {
+        char *end = nullptr;
+        unsigned long val = strtoul(argv[1], &end, 10);
+        if (*end != '\0' || val == 0UL || val > 16UL) {
+            shell_error(sh, "Использование: oled flushcheck [1..16]");
+            return -EINVAL;
+        }
+        writes = static_cast<uint32_t>(val);
+    }
+
+    display::DispIoCheck res;
+    int rc = display::disp_io_check(writes, &res);
+    if (rc == -ENODEV || rc == -EINVAL) {
+        shell_error(sh, "disp_io недоступен: %d", rc);
+        return rc;
+    }
+    shell_print(sh, "%u записей по %u us (mock): всего %u us, последний submit вернулся через %u us",
+        static_cast<unsigned>(res.writes), static_cast<unsigned>(res.xfer_us),
+        static_cast<unsigned>(res.total_us), static_cast<unsigned>(res.submit_max_us));
+    shell_print(sh, "не по порядку: %u, submit ждал передачу: %u -> %s",
+        static_cast<unsigned>(res.misordered), static_cast<unsigned>(res.blocked),
+        (rc == 0) ? "PASS" : "FAIL");
+    return rc;
+}
+
+/* Размеры областей для `oled bench` без аргументов: полный кадр,
+ * типичная полоса LVGL и несколько «частичных» областей дашборда. */
+static const struct { uint16_t w, h; } kBenchAreas[] = {
+    {128, 128}, {128, 16}, {64, 64}, {48, 16}, {16, 16},
+};
+
+static void bench_area(const struct shell *sh, uint16_t w, uint16_t h, uint32_t frames)
+{
+    display::DispIoBench b;
+    int rc = display::disp_io_bench(w, h, frames, &b);
+    if (rc != 0) {
+        shell_error(sh, "%ux%u: ошибка %d", static_cast<unsigned>(w),
+            static_cast<unsigned>(h), rc);
+        return;
+    }
+    /* Эффективность — от теоретического потолка линка (частота / 8). */
+    const uint32_t eff = (b.spi_hz > 0U)
+        ? static_cast<uint32_t>((static_cast<uint64_t>(b.bytes_per_s) * 800U) / b.spi_hz) : 0U;
+    shell_print(sh, "%3ux%-3u %6u B x%u (%u writes): %6u us/кадр, %7u B/s (%u%%), "
+        "CPU disp_io %u us/кадр, система %u.%u%%",
+        static_cast<unsigned>(w), static_cast<unsigned>(h),
+        static_cast<unsigned>(b.frame_bytes), static_cast<unsigned>(b.frames),
+        static_cast<unsigned>(b.writes), static_cast<unsigned>(b.frame_us),
+        static_cast<unsigned>(b.bytes_per_s), static_cast<unsigned>(eff),
+        static_cast<unsigned>(b.io_cpu_us),
+        static_cast<unsigned>(b.busy_permille / 10U), static_cast<unsigned>(b.busy_permille % 10U));
+}
+
+static int cmd_oled_bench(const struct shell *sh, size_t argc, char **argv)
+{
+    uint32_t frames = 20U;
+    unsigned long w = 0UL;
+    unsigned long h = 0UL;
+    bool bad = (argc > 3);
+
+    if (argc >= 2) {
+        char *end = nullptr;
+        w = strtoul(argv[1], &end, 10);
+        if (*end == 'x') {
+            h = strtoul(end + 1, &end, 10);
+        }
+        bad = bad || *end != '\0' || w == 0UL || h == 0UL || w > 0xFFFFUL || h > 0xFFFFUL;
+    }
+    if (bad) {
+        shell_error(sh, "Использование: oled bench [ШxВ [кадров]]");
+        return -EINVAL;
+    }
+    if (argc == 3) {
+        char *end = nullptr;
+        unsigned long val = strtoul(argv[2], &end, 10);
+        if (*end != '\0' || val == 0UL || val > 1000UL) {
+            shell_error(sh, "кадров: 1..1000");
+            return -EINVAL;
+        }
+        frames = static_cast<uint32_t>(val);
+    }
+
+    /* mipi_dbi_spi берёт частоту из devicetree при каждой записи, менять её
+     * в рантайме драйвер не даёт — поэтому вместо развёртки по частоте
+     * развёртка по размеру области при фиксированной mipi-max-frequency. */
+    const uint32_t hz = display::disp_io_link_hz();
+    shell_print(sh, "SPI %u Гц (mipi-max-frequency), потолок %u B/s; частота фиксирована DT",
+        static_cast<unsigned>(hz), static_cast<unsigned>(hz / 8U));
+
+    if (argc >= 2) {
+        bench_area(sh, static_cast<uint16_t>(w), static_cast<uint16_t>(h), frames);
+        return 0;
+    }
+    for (const auto &a : kBenchAreas) {
+        bench_area(sh, a.w, a.h, frames);
+    }
+    return 0;
+}
+#endif
+
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_oled,
     SHELL_CMD(bg,   NULL, "Цвет фона экрана (RRGGBB)", cmd_oled_bg),
-    SHELL_CMD(info, NULL, "Статистика CPU/FPS",         cmd_oled_info),
+    SHELL_CMD(info, NULL, "Статистика CPU/FPS/SPI",     cmd_oled_info),
+    SHELL_CMD(mem,  NULL, "Пул LVGL и рекомендуемый размер", cmd_oled_mem),
+    SHELL_CMD(reset, NULL, "Сброс статистики кадров",   cmd_oled_reset),
+#if defined(CONFIG_APP_DISP_IO)
+    SHELL_CMD(flushcheck, NULL, "Проверка асинхронного flush на mock-панели [n]",
+        cmd_oled_flushcheck),
+    SHELL_CMD(bench, NULL, "Пропускная способность линка: [ШxВ [кадров]]",
+        cmd_oled_bench),
+#endif
     SHELL_SUBCMD_SET_END
 );
 
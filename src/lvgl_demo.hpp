@@ -1,7 +1,11 @@
 #pragma once
+#include <zephyr/kernel.h>
 #include <cstdint>
+#include "widget_binding.hpp"
+#include "widget_mailbox.hpp"
 
 struct shell;
+struct _lv_event_t;
 
 /* Управляет LVGL-экраном: инициализация SLS-UI, обновление виджетов.
  * Используется как синглтон — один дисплей, один экземпляр. */
@@ -10,20 +14,23 @@ public:
     /* Доступ к единственному экземпляру. */
     static LvglDemo &instance();
 
-    /* Инициализирует дисплей и SLS-UI. Вызывать один раз при старте. */
+    /* Инициализирует дисплей и SLS-UI и запускает периодическое
+     * обновление виджетов. Вызывать один раз при старте. */
     void init();
 
-    /* Вызывается каждые ~16 мс из главного потока. */
-    void tick(uint32_t tick_ms);
-
-    /* Устанавливает цвет фона экрана (RGB hex, напр. 0x04080f). */
+    /* Устанавливает цвет фона экрана (RGB hex, напр. 0x04080f).
+     * Из любого потока, не ждёт LVGL: применяется перед ближайшим кадром. */
     void set_bg_color(uint32_t rgb_hex);
 
+    /* Реально отрисованные кадры в секунду (события LVGL, см.
+     * monitor/flush_stats), обновляется раз в 500 мс. */
+    uint16_t fps() const { return fps_current_; }
+
     /* Выводит текущую статистику в Shell. */
     void print_stats(const struct shell *sh) const;
 
 private:
-    LvglDemo() = default;
+    LvglDemo();
 
     /* Настраивает начальные значения SLS-виджетов после ui_init(). */
     void setup_widgets();
@@ -31,17 +38,44 @@ private:
     /* Считывает загрузку CPU, возвращает проценты (0..100). */
     uint8_t sample_cpu();
 
-    /* Обновляет ui_Arc1 и ui_Label1 под lvgl_lock. */
-    void update_widgets(uint8_t cpu_pct, uint16_t fps);
+    /* Отправляет новые значения виджетов в mailbox_, без lvgl_lock. */
+    void update_widgets(uint8_t cpu_pct);
+
+    /* Виджеты, обновляемые через mailbox_. */
+    enum WidgetId : uint32_t { kArc, kCpu, kHhmm, kSec, kBg, kWidgetCount };
+
+    /* post() + будит разбор на workqueue LVGL. */
+    void post(WidgetId id, int32_t value);
+
+    /* Разбирает mailbox_ и применяет изменения. Только в потоке LVGL,
+     * под lvgl_lock (перед рендером кадра или из drain_work_). */
+    void apply_pending();
+    static void drain_handler(struct k_work *work);
+    static void refr_start_cb(struct _lv_event_t *e);
+
+    /* Обработчик update_work_: замер + обновление, перепланирование. */
+    static void update_handler(struct k_work *work);
+
+    /* Ставит update_work_ на следующий абсолютный дедлайн. */
+    void schedule_next();
 
     bool     ready_        {false};
-    uint32_t fps_count_    {0};
-    uint32_t fps_last_ms_  {0};
+    struct k_work_delayable update_work_ {};
+    struct k_work drain_work_ {};
+    WidgetMailbox<kWidgetCount> mailbox_;
+    int64_t  next_update_ms_ {0};
+    uint32_t update_late_max_ms_ {0};
     uint16_t fps_current_  {0};
     uint16_t cpu_permille_ {0};
     uint32_t bg_color_     {0x04080f};
+    uint32_t ui_pool_bytes_ {0};   /* пул LVGL, занятый ui_init() */
+
+    /* Привязки виджетов: -1 = нет данных («--»). */
+    WidgetBinding<int32_t> arc_;
+    WidgetBinding<int32_t> cpu_label_;
+    WidgetBinding<int32_t> hhmm_label_;   /* часы * 60 + минуты */
+    WidgetBinding<int32_t> sec_label_;
 };
 
 /* C-совместимый API: вызывается из app_main.cpp. */
 void lvgl_demo_init();
-void lvgl_demo_tick(uint32_t tick_ms);
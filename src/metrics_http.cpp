@@ -0,0 +1,231 @@
+#include "metrics_http.hpp"
+#include "lvgl_demo.hpp"
+#include "monitor/top_collector.hpp"
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/http/server.h>
+#include <zephyr/net/http/service.h>
+#include <zephyr/sys/printk.h>
+#include <cstdint>
+ 
+#define METRICS_CHUNK_SIZE 256
+ 
+LOG_MODULE_REGISTER(metrics_http, LOG_LEVEL_INF);
+ 
+/* GET /metrics in Prometheus text format. The scrape is produced by a small
+ * state machine: every callback invocation fills one fixed chunk buffer with
+ * as many whole lines as fit and the server writes it straight to the socket
+ * (chunked transfer), so nothing is allocated per scrape.
+ */
+namespace {
+enum class Step : uint8_t {
+	Uptime,
+	Load,
+	HeapUsed,
+	HeapFree,
+	HeapPeak,
+	MinStack,
+	Fps,
+	LogProcessed,
+	LogDropped,
+	ThreadCyclesHdr,
+	ThreadCycles,
+	ThreadStackHdr,
+	ThreadStack,
+	Done,
+};
+ 
+/* One scrape at a time: the snapshot and chunk buffer are shared, so net.conf
+ * limits the server to one client. The owner still guards against a scrape
+ * left half-done by a connection that went away without an abort callback.
+ */
+struct ScrapeState {
+	bool active;
+	const struct http_client_ctx *owner;
+	Step step;
+	uint32_t row;
+};
+} // namespace
+ 
+static uint16_t metrics_port = CONFIG_APP_METRICS_PORT;
+static char chunk[METRICS_CHUNK_SIZE];
+static ScrapeState scrape;
+static monitor::TopSnapshot metrics_snap;
+static monitor::CycleTracker metrics_tracker;
+ 
+static int emit_gauge(char *out, size_t len, const char *name, const char *help, const char *type,
+		      uint64_t value)
+{
+	return snprintk(out, len, "# HELP %s %s\n# TYPE %s %s\n%s %llu\n", name, help, name, type, name,
+			(unsigned long long)value);
+}
+ 
+static const char *row_name(uint32_t row)
+{
+	const char *name = metrics_snap.rows[row].name;
+ 
+	return ((name != nullptr) && (name[0] != '\0')) ? name : "noname";
+}
+ 
+/* Thread names repeat (log_bench workers, unnamed threads), the thread
+ * object address does not, so it keeps the series apart.
+ */
+static unsigned long row_tid(uint32_t row)
+{
+	return static_cast<unsigned long>(reinterpret_cast<uintptr_t>(metrics_snap.rows[row].tid));
+}
+ 
+/* Writes the current step into out; returns the length snprintk wanted. */
+static int emit_step(char *out, size_t len)
+{
+	const monitor::TopSnapshot *snap = &metrics_snap;
+	const auto &heap = snap->heap_stats;
+ 
+	switch (scrape.step) {
+	case Step::Uptime:
+		return emit_gauge(out, len, "zephyr_uptime_seconds", "Time since boot.", "counter",
+				  snap->uptime_s);
+	case Step::Load:
+		return snprintk(out, len,
+				"# HELP zephyr_cpu_load_ratio CPU load since the previous scrape.\n"
+				"# TYPE zephyr_cpu_load_ratio gauge\n"
+				"zephyr_cpu_load_ratio %d.%03d\n",
+				snap->load_permille / 1000, snap->load_permille % 1000);
+	case Step::HeapUsed:
+		return emit_gauge(out, len, "zephyr_heap_used_bytes", "System heap allocated bytes.",
+				  "gauge", snap->heap_ok ? heap.allocated_bytes : 0U);
+	case Step::HeapFree:
+		return emit_gauge(out, len, "zephyr_heap_free_bytes", "System heap free bytes.", "gauge",
+				  snap->heap_ok ? heap.free_bytes : 0U);
+	case Step::HeapPeak:
+		return emit_gauge(out, len, "zephyr_heap_peak_bytes", "System heap high-water mark.",
+				  "gauge", snap->heap_ok ? heap.max_allocated_bytes : 0U);
+	case Step::MinStack:
+		return emit_gauge(out, len, "zephyr_stack_min_free_bytes",
+				  "Smallest free stack across threads.", "gauge", snap->min_free_stack);
+	case Step::Fps:
+		return emit_gauge(out, len, "zephyr_lvgl_fps", "LVGL frames per second.", "gauge",
+				  LvglDemo::instance().fps());
+	case Step::LogProcessed:
+		return emit_gauge(out, len, "zephyr_log_messages_total", "Log messages processed.",
+				  "counter", snap->log.processed);
+	case Step::LogDropped:
+		return emit_gauge(out, len, "zephyr_log_dropped_total", "Log messages dropped.",
+				  "counter", snap->log.dropped);
+	case Step::ThreadCyclesHdr:
+		return snprintk(out, len,
+				"# HELP zephyr_thread_cycles_total Cycles executed by the thread.\n"
+				"# TYPE zephyr_thread_cycles_total counter\n");
+	case Step::ThreadCycles:
+		return snprintk(out, len,
+				"zephyr_thread_cycles_total{thread=\"%s\",tid=\"0x%08lx\",prio=\"%d\"} %llu\n",
+				row_name(scrape.row), row_tid(scrape.row), snap->rows[scrape.row].prio,
+				(unsigned long long)snap->rows[scrape.row].total_cycles);
+	case Step::ThreadStackHdr:
+		return snprintk(out, len,
+				"# HELP zephyr_thread_stack_free_bytes Unused stack of the thread.\n"
+				"# TYPE zephyr_thread_stack_free_bytes gauge\n");
+	case Step::ThreadStack:
+		return snprintk(out, len,
+				"zephyr_thread_stack_free_bytes{thread=\"%s\",tid=\"0x%08lx\"} %u\n",
+				row_name(scrape.row), row_tid(scrape.row),
+				(unsigned int)snap->rows[scrape.row].stack_free);
+	case Step::Done:
+	default:
+		return 0;
+	}
+}
+ 
+static void advance_step()
+{
+	if ((scrape.step == Step::ThreadCycles) || (scrape.step == Step::ThreadStack)) {
+		if (++scrape.row < metrics_snap.rows_count) {
+			return;
+		}
+		scrape.row = 0;
+	}
+ 
+	scrape.step = static_cast<Step>(static_cast<uint8_t>(scrape.step) + 1U);
+	if (((scrape.step == Step::ThreadCycles) || (scrape.step == Step::ThreadStack)) &&
+	    (metrics_snap.rows_count == 0U)) {
+		scrape.step = static_cast<Step>(static_cast<uint8_t>(scrape.step) + 1U);
+	}
+}
+ 
+static size_t fill_chunk()
+{
+	size_t used = 0;
+ 
+	while (scrape.step != Step::Done) {
+		int n = emit_step(&chunk[used], sizeof(chunk) - used);
+ 
+		if ((n < 0) || (static_cast<size_t>(n) >= (sizeof(chunk) - used))) {
+			/* Line does not fit: send what we have, retry it in the next chunk. */
+			break;
+		}
+		used += static_cast<size_t>(n);
+		advance_step();
+	}
+	return used;
+}
+ 
+static int metrics_handler(struct http_client_ctx *client, enum http_data_status status,
+			   const struct http_request_ctx *request_ctx,
+			   struct http_response_ctx *response_ctx, void *user_data)
+{
+	ARG_UNUSED(request_ctx);
+	ARG_UNUSED(user_data);
+ 
+	if (status == HTTP_SERVER_DATA_ABORTED) {
+		if (scrape.owner == client) {
+			scrape.active = false;
+		}
+		return 0;
+	}
+	if (status != HTTP_SERVER_DATA_FINAL) {
+		return 0;
+	}
+ 
+	if (!scrape.active || (scrape.owner != client)) {
+		monitor::collect_top_snapshot(&metrics_snap, &metrics_tracker);
+		scrape.active = true;
+		scrape.owner = client;
+		scrape.step = Step::Uptime;
+		scrape.row = 0;
+	}
+ 
+	response_ctx->body = reinterpret_cast<const uint8_t *>(chunk);
+	response_ctx->body_len = fill_chunk();
+	response_ctx->final_chunk = (scrape.step == Step::Done);
+	if (response_ctx->final_chunk) {
+		scrape.active = false;
+	}
+	return 0;
+}
+ 
+/* Filled in metrics_http_start(): field order of the detail structs differs
+ * between Zephyr releases, which C++ designated initializers don't tolerate.
+ */
+static struct http_resource_detail_dynamic metrics_detail;
+ 
+HTTP_SERVICE_DEFINE(metrics_service, NULL, &metrics_port, 1, 1, NULL, NULL);
+HTTP_RESOURCE_DEFINE(metrics_resource, metrics_service, "/metrics", &metrics_detail);
+ 
+int metrics_http_start()
+{
+	int rc;
+ 
+	metrics_detail.common.type = HTTP_RESOURCE_TYPE_DYNAMIC;
+	metrics_detail.common.bitmask_of_supported_http_methods = BIT(HTTP_GET);
+	metrics_detail.common.content_type = "text/plain; version=0.0.4";
+	metrics_detail.cb = metrics_handler;
+	metrics_detail.user_data = nullptr;
+ 
+	rc = http_server_start();
+	if (rc < 0) {
+		LOG_ERR("HTTP server start failed: %d", rc);
+		return rc;
+	}
+	LOG_INF("Metrics at http://<board>:%u/metrics", metrics_port);
+	return 0;
+}
@@ -0,0 +1,250 @@
+#include "flush_stats.hpp"
+#include <zephyr/kernel.h>
+#include <lvgl.h>
+#include <string.h>
+ 
+/* Per-frame SPI traffic and timing. LVGL emits FLUSH_START once per (already
+ * joined) dirty area it sends to the driver, between REFR_START and
+ * REFR_READY of the frame, so summing the area sizes gives the bytes written
+ * to the panel. A frame is counted only if it flushed something, which makes
+ * the FPS figure the rate of frames actually rendered, not of refresh timer
+ * runs.
+ *
+ * frame time: REFR_START..REFR_READY.
+ * render time: frame time minus LVGL waiting for a flush (FLUSH_WAIT_*).
+ * flush time: display_write() as reported by disp_io, or FLUSH_START..
+ * FLUSH_FINISH when the flush callback is synchronous.
+ */
+namespace monitor {
+namespace {
+struct FrameSample {
+	uint32_t frame_cyc;
+	uint32_t render_cyc;
+	uint32_t pixels;
+};
+} // namespace
+ 
+static struct k_spinlock stats_lock;
+static FlushStats stats;
+static FrameSample frame_ring[kFrameWindow];
+static uint32_t frame_head;
+static uint32_t frame_count;
+static uint32_t flush_ring[kFrameWindow];
+static uint32_t flush_head;
+static uint32_t flush_count;
+static uint32_t hist[kFrameHistBuckets];
+static uint32_t fps;
+static uint32_t fps_frames;
+static uint32_t fps_window_ms;
+ 
+static uint32_t frame_bytes;
+static uint32_t frame_areas;
+static uint32_t bytes_per_px;
+static uint32_t frame_start_cyc;
+static uint32_t wait_start_cyc;
+static uint32_t frame_wait_cyc;
+static uint32_t flush_start_cyc;
+ 
+static uint32_t hist_bucket(uint32_t frame_cyc)
+{
+	uint32_t ms = k_cyc_to_ms_floor32(frame_cyc);
+ 
+	for (uint32_t i = 0; i < (kFrameHistBuckets - 1U); ++i) {
+		if (ms < kFrameHistLimitsMs[i]) {
+			return i;
+		}
+	}
+	return kFrameHistBuckets - 1U;
+}
+ 
+static void push_flush(uint32_t cycles)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+ 
+	flush_ring[flush_head] = cycles;
+	flush_head = (flush_head + 1U) % kFrameWindow;
+	flush_count = MIN(flush_count + 1U, kFrameWindow);
+	k_spin_unlock(&stats_lock, key);
+}
+ 
+static void frame_done()
+{
+	uint32_t frame = k_cycle_get_32() - frame_start_cyc;
+	uint32_t now_ms = k_uptime_get_32();
+	FrameSample sample = {frame, frame - frame_wait_cyc, frame_bytes / MAX(bytes_per_px, 1U)};
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+ 
+	stats.frames++;
+	stats.areas += frame_areas;
+	stats.bytes += frame_bytes;
+	stats.last_frame_bytes = frame_bytes;
+	stats.last_frame_areas = frame_areas;
+	stats.max_frame_bytes = MAX(stats.max_frame_bytes, frame_bytes);
+	stats.render_cyc += sample.render_cyc;
+	stats.render_cyc_max = MAX(stats.render_cyc_max, sample.render_cyc);
+ 
+	frame_ring[frame_head] = sample;
+	frame_head = (frame_head + 1U) % kFrameWindow;
+	frame_count = MIN(frame_count + 1U, kFrameWindow);
+	hist[hist_bucket(frame)]++;
+ 
+	fps_frames++;
+	if ((now_ms - fps_window_ms) >= MSEC_PER_SEC) {
+		fps = (fps_frames * MSEC_PER_SEC) / (now_ms - fps_window_ms);
+		fps_frames = 0;
+		fps_window_ms = now_ms;
+	}
+	k_spin_unlock(&stats_lock, key);
+}
+ 
+static void on_display_event(lv_event_t *e)
+{
+	lv_event_code_t code = lv_event_get_code(e);
+ 
+	if (code == LV_EVENT_REFR_START) {
+		frame_bytes = 0;
+		frame_areas = 0;
+		frame_wait_cyc = 0;
+		frame_start_cyc = k_cycle_get_32();
+	} else if (code == LV_EVENT_FLUSH_WAIT_START) {
+		wait_start_cyc = k_cycle_get_32();
+	} else if (code == LV_EVENT_FLUSH_WAIT_FINISH) {
+		frame_wait_cyc += k_cycle_get_32() - wait_start_cyc;
+	} else if (code == LV_EVENT_FLUSH_START) {
+		const auto *area = static_cast<const lv_area_t *>(lv_event_get_param(e));
+ 
+		if (area != nullptr) {
+			frame_bytes += static_cast<uint32_t>(lv_area_get_size(area)) * bytes_per_px;
+			frame_areas++;
+		}
+		flush_start_cyc = k_cycle_get_32();
+	} else if (code == LV_EVENT_FLUSH_FINISH) {
+		if (!IS_ENABLED(CONFIG_APP_DISP_IO)) {
+			push_flush(k_cycle_get_32() - flush_start_cyc);
+		}
+	} else if ((code == LV_EVENT_REFR_READY) && (frame_areas > 0U)) {
+		frame_done();
+	}
+}
+ 
+void flush_stats_attach(lv_display_t *disp)
+{
+	if (disp == nullptr) {
+		return;
+	}
+ 
+	bytes_per_px = lv_color_format_get_size(lv_display_get_color_format(disp));
+	stats.full_frame_bytes = static_cast<uint32_t>(lv_display_get_horizontal_resolution(disp)) *
+				 static_cast<uint32_t>(lv_display_get_vertical_resolution(disp)) *
+				 bytes_per_px;
+	fps_window_ms = k_uptime_get_32();
+	lv_display_add_event_cb(disp, on_display_event, LV_EVENT_REFR_START, nullptr);
+	lv_display_add_event_cb(disp, on_display_event, LV_EVENT_FLUSH_START, nullptr);
+	lv_display_add_event_cb(disp, on_display_event, LV_EVENT_FLUSH_FINISH, nullptr);
+	lv_display_add_event_cb(disp, on_display_event, LV_EVENT_REFR_READY, nullptr);
+	lv_display_add_event_cb(disp, on_display_event, LV_EVENT_FLUSH_WAIT_START, nullptr);
+	lv_display_add_event_cb(disp, on_display_event, LV_EVENT_FLUSH_WAIT_FINISH, nullptr);
+}
+ 
+void flush_stats_record_flush(uint32_t cycles)
+{
+	push_flush(cycles);
+}
+ 
+void flush_stats_get(FlushStats *out)
+{
+	if (out == nullptr) {
+		return;
+	}
+ 
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+ 
+	*out = stats;
+	k_spin_unlock(&stats_lock, key);
+}
+ 
+uint32_t flush_stats_fps()
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+	/* No frame for two windows means the screen is static: 0 FPS, not the last value. */
+	uint32_t value = ((k_uptime_get_32() - fps_window_ms) < (2U * MSEC_PER_SEC)) ? fps : 0U;
+ 
+	k_spin_unlock(&stats_lock, key);
+	return value;
+}
+ 
+static void reduce(MinAvgMax *out, const uint32_t *values, uint32_t count, bool cycles)
+{
+	uint64_t sum = 0;
+ 
+	*out = {UINT32_MAX, 0, 0};
+	for (uint32_t i = 0; i < count; ++i) {
+		out->min = MIN(out->min, values[i]);
+		out->max = MAX(out->max, values[i]);
+		sum += values[i];
+	}
+	if (count == 0U) {
+		*out = {};
+		return;
+	}
+	out->avg = static_cast<uint32_t>(sum / count);
+	if (cycles) {
+		out->min = k_cyc_to_us_floor32(out->min);
+		out->avg = k_cyc_to_us_floor32(out->avg);
+		out->max = k_cyc_to_us_floor32(out->max);
+	}
+}
+ 
+void flush_stats_timing(FrameTiming *out)
+{
+	static uint32_t frame_cyc[kFrameWindow];
+	static uint32_t render_cyc[kFrameWindow];
+	static uint32_t pixels[kFrameWindow];
+	static uint32_t flushes[kFrameWindow];
+	static K_MUTEX_DEFINE(timing_lock);
+	uint32_t frames;
+	uint32_t flush_n;
+ 
+	if (out == nullptr) {
+		return;
+	}
+ 
+	/* Copy out under the spinlock, reduce outside of it. */
+	k_mutex_lock(&timing_lock, K_FOREVER);
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+ 
+	frames = frame_count;
+	flush_n = flush_count;
+	for (uint32_t i = 0; i < frames; ++i) {
+		frame_cyc[i] = frame_ring[i].frame_cyc;
+		render_cyc[i] = frame_ring[i].render_cyc;
+		pixels[i] = frame_ring[i].pixels;
+	}
+	memcpy(flushes, flush_ring, flush_n * sizeof(flushes[0]));
+	memcpy(out->hist, hist, sizeof(out->hist));
+	k_spin_unlock(&stats_lock, key);
+ 
+	out->fps = flush_stats_fps();
+	out->samples = frames;
+	reduce(&out->frame_us, frame_cyc, frames, true);
+	reduce(&out->render_us, render_cyc, frames, true);
+	reduce(&out->flush_us, flushes, flush_n, true);
+	reduce(&out->pixels, pixels, frames, false);
+	k_mutex_unlock(&timing_lock);
+}
+ 
+void flush_stats_reset()
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+	uint32_t full = stats.full_frame_bytes;
+ 
+	stats = {};
+	stats.full_frame_bytes = full;
+	frame_head = 0;
+	frame_count = 0;
+	flush_head = 0;
+	flush_count = 0;
+	memset(hist, 0, sizeof(hist));
+	k_spin_unlock(&stats_lock, key);
+}
+} // namespace monitor
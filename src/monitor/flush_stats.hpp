@@ -0,0 +1,51 @@
+#pragma once
+ 
+#include <cstdint>
+ 
+struct _lv_display_t;
+ 
+namespace monitor {
+constexpr uint32_t kFrameWindow = 64;
+constexpr uint32_t kFrameHistBuckets = 9;
+/* Upper bounds of the frame-time histogram buckets in ms; the last bucket is open. */
+constexpr uint16_t kFrameHistLimitsMs[kFrameHistBuckets - 1] = {1, 2, 4, 8, 16, 25, 33, 50};
+ 
+struct FlushStats {
+	uint32_t frames;
+	uint32_t areas;
+	uint64_t bytes;
+	uint32_t last_frame_bytes;
+	uint32_t last_frame_areas;
+	uint32_t max_frame_bytes;
+	uint32_t full_frame_bytes;
+	uint64_t render_cyc;
+	uint32_t render_cyc_max;
+};
+ 
+struct MinAvgMax {
+	uint32_t min;
+	uint32_t avg;
+	uint32_t max;
+};
+ 
+/* Rolling figures over the last kFrameWindow rendered frames, times in us. */
+struct FrameTiming {
+	uint32_t fps;
+	uint32_t samples;
+	MinAvgMax frame_us;
+	MinAvgMax render_us;
+	MinAvgMax flush_us;
+	MinAvgMax pixels;
+	uint32_t hist[kFrameHistBuckets];
+};
+ 
+/* Hooks the display's refresh/flush events. Call once with the LVGL lock held. */
+void flush_stats_attach(struct _lv_display_t *disp);
+void flush_stats_get(FlushStats *out);
+void flush_stats_timing(FrameTiming *out);
+uint32_t flush_stats_fps();
+void flush_stats_reset();
+ 
+/* Duration of one display_write() from a custom flush path (disp_io). */
+void flush_stats_record_flush(uint32_t cycles);
+} // namespace monitor
@@ -0,0 +1,172 @@
+#pragma once
+ 
+#include <cstddef>
+#include <cstdint>
+ 
+/* Fixed-width integer formatting without printf: two digits per division
+ * through a constexpr pair table, left-aligned space padding like %-Nu and
+ * zero padding like %02u. Used on paths that run every frame or every top
+ * refresh, where printf's format parsing dominates the cost.
+ */
+namespace monitor {
+namespace fmt {
+constexpr char kDigitPairs[] =
+	"0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+	"5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+constexpr size_t kU32Digits = 10;
+constexpr size_t kU64Digits = 20;
+ 
+/* Writes v in decimal to out (no terminator), returns the length. */
+inline size_t u32(char *out, uint32_t v)
+{
+	char tmp[kU32Digits];
+	size_t n = 0;
+ 
+	while (v >= 100U) {
+		uint32_t q = v / 100U;
+		uint32_t r = (v - (q * 100U)) * 2U;
+ 
+		tmp[n++] = kDigitPairs[r + 1U];
+		tmp[n++] = kDigitPairs[r];
+		v = q;
+	}
+	if (v >= 10U) {
+		tmp[n++] = kDigitPairs[(v * 2U) + 1U];
+		tmp[n++] = kDigitPairs[v * 2U];
+	} else {
+		tmp[n++] = static_cast<char>('0' + v);
+	}
+	for (size_t i = 0; i < n; ++i) {
+		out[i] = tmp[n - 1U - i];
+	}
+	return n;
+}
+ 
+inline size_t u64(char *out, uint64_t v)
+{
+	if (v <= UINT32_MAX) {
+		return u32(out, static_cast<uint32_t>(v));
+	}
+ 
+	/* Split off the low 9 digits so the rest is 32-bit arithmetic. */
+	size_t n = u64(out, v / 1000000000U);
+	uint32_t low = static_cast<uint32_t>(v % 1000000000U);
+ 
+	for (size_t i = 9; i > 0U; --i) {
+		out[n + i - 1U] = static_cast<char>('0' + (low % 10U));
+		low /= 10U;
+	}
+	return n + 9U;
+}
+ 
+inline size_t i32(char *out, int32_t v)
+{
+	if (v >= 0) {
+		return u32(out, static_cast<uint32_t>(v));
+	}
+	out[0] = '-';
+	return 1U + u32(&out[1], 0U - static_cast<uint32_t>(v));
+}
+ 
+/* Two digits, zero padded (v < 100). */
+inline void zero2(char *out, uint32_t v)
+{
+	out[0] = kDigitPairs[(v % 100U) * 2U];
+	out[1] = kDigitPairs[((v % 100U) * 2U) + 1U];
+}
+ 
+/* Bounded line builder; output past N - 1 characters is dropped. */
+template <size_t N>
+class Line {
+public:
+	void clear()
+	{
+		len_ = 0;
+		buf_[0] = '\0';
+	}
+ 
+	const char *c_str() const { return buf_; }
+	size_t size() const { return len_; }
+ 
+	Line &ch(char c)
+	{
+		if (len_ < (N - 1U)) {
+			buf_[len_++] = c;
+			buf_[len_] = '\0';
+		}
+		return *this;
+	}
+ 
+	/* %-<width>s */
+	Line &str(const char *s, size_t width = 0)
+	{
+		size_t start = len_;
+ 
+		while ((*s != '\0') && (len_ < (N - 1U))) {
+			buf_[len_++] = *s++;
+		}
+		return pad(start, width);
+	}
+ 
+	/* %-<width>u, %-<width>llu, %-<width>d */
+	Line &u32(uint32_t v, size_t width = 0)
+	{
+		char tmp[kU32Digits];
+ 
+		return digits(tmp, fmt::u32(tmp, v), width);
+	}
+ 
+	Line &u64(uint64_t v, size_t width = 0)
+	{
+		char tmp[kU64Digits];
+ 
+		return digits(tmp, fmt::u64(tmp, v), width);
+	}
+ 
+	Line &i32(int32_t v, size_t width = 0)
+	{
+		char tmp[kU32Digits + 1U];
+ 
+		return digits(tmp, fmt::i32(tmp, v), width);
+	}
+ 
+	/* %02u */
+	Line &zero2(uint32_t v)
+	{
+		char tmp[2];
+ 
+		fmt::zero2(tmp, v);
+		return digits(tmp, 2U, 0U);
+	}
+ 
+	/* %04u (v < 10000) */
+	Line &zero4(uint32_t v)
+	{
+		return zero2(v / 100U).zero2(v);
+	}
+ 
+private:
+	Line &digits(const char *d, size_t n, size_t width)
+	{
+		size_t start = len_;
+ 
+		for (size_t i = 0; (i < n) && (len_ < (N - 1U)); ++i) {
+			buf_[len_++] = d[i];
+		}
+		return pad(start, width);
+	}
+ 
+	Line &pad(size_t start, size_t width)
+	{
+		while (((len_ - start) < width) && (len_ < (N - 1U))) {
+			buf_[len_++] = ' ';
+		}
+		buf_[len_] = '\0';
+		return *this;
+	}
+ 
+	char buf_[N] = {'\0'};
+	size_t len_ = 0;
+};
+} // namespace fmt
+} // namespace monitor
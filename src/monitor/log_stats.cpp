@@ -0,0 +1,95 @@
+#include "log_stats.hpp"
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log_backend.h>
+#include <zephyr/logging/log_ctrl.h>
+#include <zephyr/logging/log_internal.h>
+#include <zephyr/logging/log_msg.h>
+#include <zephyr/logging/log_output.h>
+#include <zephyr/sys/atomic.h>
+ 
+/* Counting-only log backend. It sees every message the log thread processes
+ * and every drop notification, so the counters cover silent log loss too.
+ */
+namespace monitor {
+static atomic_t processed;
+static atomic_t dropped;
+static struct k_spinlock latency_lock;
+static uint32_t latency_max_us;
+static uint64_t latency_sum_us;
+static uint32_t latency_samples;
+ 
+static void tap_process(const struct log_backend *const backend, union log_msg_generic *msg)
+{
+	ARG_UNUSED(backend);
+ 
+	atomic_inc(&processed);
+	/* Message timestamps come from the log timestamp source, which is not
+	 * the cycle counter on every target (the H743 logs k_uptime ms), so take
+	 * "now" from the same source and let the log core convert the delta.
+	 */
+	log_timestamp_t delta = z_log_timestamp() - log_msg_get_timestamp(&msg->log);
+	auto latency = static_cast<uint32_t>(MIN(log_output_timestamp_to_us(delta), UINT32_MAX));
+	k_spinlock_key_t key = k_spin_lock(&latency_lock);
+ 
+	latency_sum_us += latency;
+	latency_samples++;
+	if (latency > latency_max_us) {
+		latency_max_us = latency;
+	}
+	k_spin_unlock(&latency_lock, key);
+}
+ 
+static void tap_dropped(const struct log_backend *const backend, uint32_t cnt)
+{
+	ARG_UNUSED(backend);
+	(void)atomic_add(&dropped, static_cast<atomic_val_t>(cnt));
+}
+ 
+static void tap_panic(const struct log_backend *const backend)
+{
+	ARG_UNUSED(backend);
+}
+ 
+static const struct log_backend_api tap_api = {
+	.process = tap_process,
+	.dropped = tap_dropped,
+	.panic = tap_panic,
+};
+ 
+LOG_BACKEND_DEFINE(log_stats_tap, tap_api, true);
+ 
+void log_stats_get(LogStats *out)
+{
+	if (out == nullptr) {
+		return;
+	}
+ 
+	out->processed = static_cast<uint32_t>(atomic_get(&processed));
+	out->dropped = static_cast<uint32_t>(atomic_get(&dropped));
+ 
+	k_spinlock_key_t key = k_spin_lock(&latency_lock);
+ 
+	out->latency_max_us = latency_max_us;
+	out->latency_sum_us = latency_sum_us;
+	out->latency_samples = latency_samples;
+	k_spin_unlock(&latency_lock, key);
+ 
+	out->buf_ok = (log_mem_get_usage(&out->buf_size, &out->buf_used) == 0) &&
+		      (log_mem_get_max_usage(&out->buf_peak) == 0);
+	if (!out->buf_ok) {
+		out->buf_size = 0;
+		out->buf_used = 0;
+		out->buf_peak = 0;
+	}
+}
+ 
+void log_stats_reset_latency()
+{
+	k_spinlock_key_t key = k_spin_lock(&latency_lock);
+ 
+	latency_max_us = 0;
+	latency_sum_us = 0;
+	latency_samples = 0;
+	k_spin_unlock(&latency_lock, key);
+}
+} // namespace monitor
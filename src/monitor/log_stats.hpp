@@ -0,0 +1,20 @@
+#pragma once
+ 
+#include <cstdint>
+ 
+namespace monitor {
+struct LogStats {
+	uint32_t processed;
+	uint32_t dropped;
+	uint32_t latency_max_us;
+	uint64_t latency_sum_us;
+	uint32_t latency_samples;
+	bool buf_ok;
+	uint32_t buf_size;
+	uint32_t buf_used;
+	uint32_t buf_peak;
+};
+ 
+void log_stats_get(LogStats *out);
+void log_stats_reset_latency();
+} // namespace monitor
@@ -0,0 +1,74 @@
+#include "lvgl_mem.hpp"
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <lvgl.h>
+#include <lvgl_zephyr.h>
+ 
+LOG_MODULE_REGISTER(lvgl_mem, LOG_LEVEL_INF);
+ 
+/* LVGL pool usage for right-sizing CONFIG_LV_Z_MEM_POOL_SIZE. The peak is
+ * the larger of the allocator's own max_used (sys_heap runtime stats) and
+ * the used bytes seen at each poll, so it stays meaningful if the backend
+ * leaves max_used at 0.
+ */
+namespace monitor {
+static uint32_t peak_used;
+static uint32_t peak_logged;
+ 
+uint32_t lvgl_mem_recommended(uint32_t peak)
+{
+	uint64_t want = (static_cast<uint64_t>(peak) * (100U + kLvglMemHeadroomPct)) / 100U;
+ 
+	return static_cast<uint32_t>(((want + kLvglMemRoundBytes - 1U) / kLvglMemRoundBytes) *
+				     kLvglMemRoundBytes);
+}
+ 
+void lvgl_mem_poll(LvglMemStats *out)
+{
+	lv_mem_monitor_t mon;
+ 
+	lvgl_lock();
+	lv_mem_monitor(&mon);
+	lvgl_unlock();
+ 
+	uint32_t total = static_cast<uint32_t>(mon.total_size);
+	uint32_t free_bytes = static_cast<uint32_t>(mon.free_size);
+	uint32_t used = (total > free_bytes) ? (total - free_bytes) : 0U;
+ 
+	if (total == 0U) {
+		/* Backend without total_size: the pool is what Kconfig reserved. */
+		total = CONFIG_LV_Z_MEM_POOL_SIZE;
+		used = (total > free_bytes) ? (total - free_bytes) : 0U;
+	}
+	if (static_cast<uint32_t>(mon.max_used) > peak_used) {
+		peak_used = static_cast<uint32_t>(mon.max_used);
+	}
+	if (used > peak_used) {
+		peak_used = used;
+	}
+	if (peak_used > peak_logged) {
+		LOG_INF("LVGL pool peak %u of %u B, recommended pool %u B", peak_used, total,
+			lvgl_mem_recommended(peak_used));
+		peak_logged = peak_used;
+	}
+ 
+	if (out == nullptr) {
+		return;
+	}
+	out->total = total;
+	out->used = used;
+	out->free = free_bytes;
+	out->biggest_free = static_cast<uint32_t>(mon.free_biggest_size);
+	out->frag_pct = mon.frag_pct;
+	if ((out->frag_pct == 0U) && (out->biggest_free > 0U) && (free_bytes > 0U)) {
+		/* Same definition as LVGL's builtin allocator. */
+		out->frag_pct = 100U - static_cast<uint32_t>(
+			(static_cast<uint64_t>(out->biggest_free) * 100U) / free_bytes);
+	}
+	out->used_pct = (total > 0U) ? static_cast<uint32_t>((static_cast<uint64_t>(used) * 100U) / total)
+				     : 0U;
+	out->used_cnt = mon.used_cnt;
+	out->peak = peak_used;
+	out->recommended = lvgl_mem_recommended(peak_used);
+}
+} // namespace monitor
@@ -0,0 +1,29 @@
+#pragma once
+ 
+#include <cstdint>
+ 
+namespace monitor {
+/* Headroom on top of the observed peak in the recommended pool size. */
+constexpr uint32_t kLvglMemHeadroomPct = 25;
+constexpr uint32_t kLvglMemRoundBytes = 1024;
+ 
+struct LvglMemStats {
+	uint32_t total;
+	uint32_t used;
+	uint32_t free;
+	uint32_t biggest_free; /* 0 when the allocator doesn't report it */
+	uint32_t frag_pct;
+	uint32_t used_pct;
+	uint32_t used_cnt;
+	uint32_t peak;
+	uint32_t recommended;
+};
+ 
+/* Samples lv_mem_monitor() and tracks the peak; logs every new peak. Takes
+ * the LVGL lock. Called periodically and from 'oled mem'.
+ */
+void lvgl_mem_poll(LvglMemStats *out = nullptr);
+ 
+/* Peak plus kLvglMemHeadroomPct, rounded up to kLvglMemRoundBytes. */
+uint32_t lvgl_mem_recommended(uint32_t peak);
+} // namespace monitor
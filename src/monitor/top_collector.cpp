@@ -6,36 +6,33 @@
 #include <cstdint>
  
 namespace monitor {
-struct PrevCycles {
-	k_tid_t tid;
-	uint64_t total_cycles;
+struct CollectCtx {
+	TopSnapshot *snap;
+	CycleTracker *tracker;
 };
  
-static PrevCycles prev[kTopMaxThreads];
-static uint32_t prev_count;
- 
-static uint64_t get_prev_cycles(k_tid_t tid)
+static uint64_t get_prev_cycles(const CycleTracker *tracker, k_tid_t tid)
 {
-	for (uint32_t i = 0; i < prev_count; ++i) {
-		if (prev[i].tid == tid) {
-			return prev[i].total_cycles;
+	for (uint32_t i = 0; i < tracker->count; ++i) {
+		if (tracker->tids[i] == tid) {
+			return tracker->cycles[i];
 		}
 	}
 	return 0;
 }
  
-static void set_prev_cycles(k_tid_t tid, uint64_t total_cycles)
+static void set_prev_cycles(CycleTracker *tracker, k_tid_t tid, uint64_t total_cycles)
 {
-	for (uint32_t i = 0; i < prev_count; ++i) {
-		if (prev[i].tid == tid) {
-			prev[i].total_cycles = total_cycles;
+	for (uint32_t i = 0; i < tracker->count; ++i) {
+		if (tracker->tids[i] == tid) {
+			tracker->cycles[i] = total_cycles;
 			return;
 		}
 	}
-	if (prev_count < kTopMaxThreads) {
-		prev[prev_count].tid = tid;
-		prev[prev_count].total_cycles = total_cycles;
-		++prev_count;
+	if (tracker->count < kTopMaxThreads) {
+		tracker->tids[tracker->count] = tid;
+		tracker->cycles[tracker->count] = total_cycles;
+		++tracker->count;
 	}
 }
  
@@ -54,7 +51,8 @@ static void sort_rows_by_delta(ThreadRow *rows, uint32_t count)
  
 static void collect_thread_stats(const struct k_thread *thread, void *user_data)
 {
-	auto *snap = static_cast<TopSnapshot *>(user_data);
+	auto *ctx = static_cast<CollectCtx *>(user_data);
+	auto *snap = ctx->snap;
 	auto *row = &snap->rows[snap->rows_count];
 	k_thread_runtime_stats_t rt = {0};
 	size_t stack_free = 0;
@@ -80,18 +78,38 @@ static void collect_thread_stats(const struct k_thread *thread, void *user_data)
  
 	if (k_thread_runtime_stats_get((k_tid_t)thread, &rt) == 0) {
 		uint64_t total = rt.total_cycles;
-		row->delta_cycles = total - get_prev_cycles((k_tid_t)thread);
-		set_prev_cycles((k_tid_t)thread, total);
+		row->total_cycles = total;
+		row->delta_cycles = total - get_prev_cycles(ctx->tracker, (k_tid_t)thread);
+		set_prev_cycles(ctx->tracker, (k_tid_t)thread, total);
 	} else {
+		row->total_cycles = 0;
 		row->delta_cycles = 0;
 	}
  
 	snap->rows_count++;
 }
  
-void collect_top_snapshot(TopSnapshot *out)
+static int load_from_tracker(const TopSnapshot *snap, CycleTracker *tracker)
 {
-	if (out == nullptr) {
+	uint64_t busy = snap->total_rt.total_cycles;
+	uint64_t idle = snap->total_rt.idle_cycles;
+	uint64_t d_busy = busy - tracker->busy_cycles;
+	uint64_t d_all = d_busy + (idle - tracker->idle_cycles);
+	bool first = (tracker->busy_cycles == 0U) && (tracker->idle_cycles == 0U);
+ 
+	tracker->busy_cycles = busy;
+	tracker->idle_cycles = idle;
+	if (first || (d_all == 0U)) {
+		return cpu_load_get(false);
+	}
+	return static_cast<int>((d_busy * 1000U) / d_all);
+}
+ 
+void collect_top_snapshot(TopSnapshot *out, CycleTracker *tracker)
+{
+	CollectCtx ctx = {out, tracker};
+ 
+	if ((out == nullptr) || (tracker == nullptr)) {
 		return;
 	}
  
@@ -101,7 +119,7 @@ void collect_top_snapshot(TopSnapshot *out)
 		.unknown_stack = 0,
 		.min_free_stack = UINT32_MAX,
 		.delta_sum = 0,
-		.load_permille = cpu_load_get(true),
+		.load_permille = 0,
 		.uptime_s = static_cast<uint32_t>(k_uptime_get() / 1000),
 		.rtc_ok = false,
 		.rtc_now = {},
@@ -109,14 +127,11 @@ void collect_top_snapshot(TopSnapshot *out)
 		.heap_stats = {},
 		.total_cycles_ok = false,
 		.total_rt = {},
+		.log = {},
 	};
  
-	if (out->load_permille < 0) {
-		out->load_permille = 0;
-	}
- 
 	out->rtc_ok = rtc_service_get(&out->rtc_now);
-	k_thread_foreach(collect_thread_stats, out);
+	k_thread_foreach(collect_thread_stats, &ctx);
 	sort_rows_by_delta(out->rows, out->rows_count);
  
 	for (uint32_t i = 0; i < out->rows_count; ++i) {
@@ -128,5 +143,11 @@ void collect_top_snapshot(TopSnapshot *out)
  
 	out->heap_ok = malloc_runtime_stats_get(&out->heap_stats) == 0;
 	out->total_cycles_ok = k_thread_runtime_stats_all_get(&out->total_rt) == 0;
+	out->load_permille = out->total_cycles_ok ? load_from_tracker(out, tracker)
+						  : cpu_load_get(false);
+	if (out->load_permille < 0) {
+		out->load_permille = 0;
+	}
+	log_stats_get(&out->log);
 }
 } // namespace monitor
\ No newline at end of file
@@ -3,5 +3,5 @@
 #include "top_model.hpp"
  
 namespace monitor {
-void collect_top_snapshot(TopSnapshot *out);
+void collect_top_snapshot(TopSnapshot *out, CycleTracker *tracker);
 }
\ No newline at end of file
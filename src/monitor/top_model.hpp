@@ -4,6 +4,7 @@
 #include <zephyr/kernel.h>
 #include <zephyr/sys/mem_stats.h>
 #include <cstdint>
+#include "log_stats.hpp"
  
 namespace monitor {
 constexpr uint32_t kTopMaxThreads = 20;
@@ -15,9 +16,21 @@ struct ThreadRow {
 	const char *name;
 	int prio;
 	uint32_t stack_free;
+	uint64_t total_cycles;
 	uint64_t delta_cycles;
 };
  
+/* Previous cycle counters of one snapshot consumer. Every consumer (top,
+ * telemetry, ...) owns its tracker so their deltas don't disturb each other.
+ */
+struct CycleTracker {
+	k_tid_t tids[kTopMaxThreads];
+	uint64_t cycles[kTopMaxThreads];
+	uint32_t count;
+	uint64_t busy_cycles;
+	uint64_t idle_cycles;
+};
+ 
 struct TopSnapshot {
 	ThreadRow rows[kTopMaxThreads];
 	uint32_t rows_count;
@@ -33,5 +46,6 @@ struct TopSnapshot {
 	struct sys_memory_stats heap_stats;
 	bool total_cycles_ok;
 	k_thread_runtime_stats_t total_rt;
+	LogStats log;
 };
 } // namespace monitor
\ No newline at end of file
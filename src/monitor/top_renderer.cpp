@@ -1,4 +1,5 @@
 #include "top_renderer.hpp"
+#include "fmt.hpp"
 #include <zephyr/sys/printk.h>
 #include <cstdint>
  
@@ -8,6 +9,7 @@ constexpr uint32_t kRowCpu = 2;
 constexpr uint32_t kRowHeap = 3;
 constexpr uint32_t kRowThr = 4;
 constexpr uint32_t kRowCyc = 5;
+constexpr uint32_t kRowLog = 6;
 constexpr uint32_t kRowHeader = 7;
 constexpr uint32_t kRowThreadsStart = 8;
  
@@ -17,11 +19,26 @@ constexpr uint32_t kRowThreadsStart = 8;
 #define ANSI_RED "\x1b[31m"
 #define ANSI_CYAN "\x1b[36m"
  
+constexpr size_t kLineLen = 192;
+ 
 static bool layout_drawn;
  
+/* Lines are assembled with fmt::Line and printed with a bare "%s", so the
+ * 1 Hz redraw does no printf format parsing per field.
+ */
+using TopLine = fmt::Line<kLineLen>;
+ 
+static void emit(const TopLine &line)
+{
+	printk("%s", line.c_str());
+}
+ 
 static void cursor_to(uint32_t row, uint32_t col)
 {
-	printk("\x1b[%u;%uH", (unsigned int)row, (unsigned int)col);
+	TopLine line;
+ 
+	line.str("\x1b[").u32(row).ch(';').u32(col).ch('H');
+	emit(line);
 }
  
 static void fill_bar(char *out, uint32_t width, uint32_t pct)
@@ -36,8 +53,16 @@ static void fill_bar(char *out, uint32_t width, uint32_t pct)
 	out[width] = '\0';
 }
  
+static void header_row(TopLine &line)
+{
+	line.str("thread", 12).ch(' ').str("prio", 5).ch(' ').str("stack(B)", 8).ch(' ')
+		.str("delta", 10).ch(' ').str("load%", 6);
+}
+ 
 void draw_layout_once()
 {
+	TopLine line;
+ 
 	if (layout_drawn) {
 		return;
 	}
@@ -48,8 +73,11 @@ void draw_layout_once()
 	printk("CPU\n");
 	printk("HEAP\n");
 	printk("THR\n");
-	printk("CYC\n\n");
-	printk("%-12s %-5s %-8s %-10s %-6s\n", "thread", "prio", "stack(B)", "delta", "load%");
+	printk("CYC\n");
+	printk("LOG\n");
+	header_row(line);
+	line.ch('\n');
+	emit(line);
 	for (uint32_t i = 0; i < kTopVisibleThreads; ++i) {
 		printk("\n");
 	}
@@ -62,6 +90,7 @@ void render_top_snapshot(const TopSnapshot *snap)
 	uint32_t load_pct;
 	const char *cpu_color;
 	uint32_t top_n;
+	TopLine line;
  
 	if (snap == nullptr) {
 		return;
@@ -72,23 +101,29 @@ void render_top_snapshot(const TopSnapshot *snap)
 	top_n = (snap->rows_count < kTopVisibleThreads) ? snap->rows_count : kTopVisibleThreads;
  
 	cursor_to(kRowTitle, 1);
-	printk(ANSI_CYAN "Zephyr TOP" ANSI_RESET "  uptime:%us  ", snap->uptime_s);
+	line.str(ANSI_CYAN "Zephyr TOP" ANSI_RESET "  uptime:").u32(snap->uptime_s).str("s  ");
 	if (snap->rtc_ok) {
-		printk("rtc:%04d-%02d-%02d %02d:%02d:%02d",
-		       snap->rtc_now.tm_year + 1900, snap->rtc_now.tm_mon + 1, snap->rtc_now.tm_mday,
-		       snap->rtc_now.tm_hour, snap->rtc_now.tm_min, snap->rtc_now.tm_sec);
+		line.str("rtc:").zero4(static_cast<uint32_t>(snap->rtc_now.tm_year + 1900)).ch('-')
+			.zero2(static_cast<uint32_t>(snap->rtc_now.tm_mon + 1)).ch('-')
+			.zero2(static_cast<uint32_t>(snap->rtc_now.tm_mday)).ch(' ')
+			.zero2(static_cast<uint32_t>(snap->rtc_now.tm_hour)).ch(':')
+			.zero2(static_cast<uint32_t>(snap->rtc_now.tm_min)).ch(':')
+			.zero2(static_cast<uint32_t>(snap->rtc_now.tm_sec));
 	} else {
-		printk("rtc:n/a");
+		line.str("rtc:n/a");
 	}
-	printk("\x1b[K");
+	line.str("\x1b[K");
+	emit(line);
  
 	fill_bar(bar, kBarWidth, load_pct);
 	cursor_to(kRowCpu, 1);
-	printk("%sCPU [%s] %d.%d%%%s", cpu_color, bar,
-	       snap->load_permille / 10, snap->load_permille % 10, ANSI_RESET);
-	printk("\x1b[K");
+	line.clear();
+	line.str(cpu_color).str("CPU [").str(bar).str("] ").i32(snap->load_permille / 10).ch('.')
+		.i32(snap->load_permille % 10).ch('%').str(ANSI_RESET "\x1b[K");
+	emit(line);
  
 	cursor_to(kRowHeap, 1);
+	line.clear();
 	if (snap->heap_ok) {
 		auto heap_total = static_cast<uint32_t>(
 			snap->heap_stats.free_bytes + snap->heap_stats.allocated_bytes);
@@ -96,35 +131,51 @@ void render_top_snapshot(const TopSnapshot *snap)
 			? static_cast<uint32_t>((snap->heap_stats.allocated_bytes * 100U) / heap_total)
 			: 0U;
 		fill_bar(bar, kBarWidth, heap_pct);
-		printk(ANSI_CYAN "HEAP" ANSI_RESET " [%s] used:%uB free:%uB peak:%uB",
-		       bar,
-		       (unsigned int)snap->heap_stats.allocated_bytes,
-		       (unsigned int)snap->heap_stats.free_bytes,
-		       (unsigned int)snap->heap_stats.max_allocated_bytes);
+		line.str(ANSI_CYAN "HEAP" ANSI_RESET " [").str(bar).str("] used:")
+			.u32(static_cast<uint32_t>(snap->heap_stats.allocated_bytes)).str("B free:")
+			.u32(static_cast<uint32_t>(snap->heap_stats.free_bytes)).str("B peak:")
+			.u32(static_cast<uint32_t>(snap->heap_stats.max_allocated_bytes)).ch('B');
 	} else {
-		printk(ANSI_CYAN "HEAP" ANSI_RESET " [------------------------------] n/a");
+		line.str(ANSI_CYAN "HEAP" ANSI_RESET " [------------------------------] n/a");
 	}
-	printk("\x1b[K");
+	line.str("\x1b[K");
+	emit(line);
  
 	cursor_to(kRowThr, 1);
-	printk(ANSI_CYAN "THR " ANSI_RESET "total:%u shown:%u min_free_stack:%uB unknown_stack:%u",
-	       (unsigned int)snap->total_threads_seen, (unsigned int)snap->rows_count,
-	       (unsigned int)snap->min_free_stack, (unsigned int)snap->unknown_stack);
-	printk("\x1b[K");
+	line.clear();
+	line.str(ANSI_CYAN "THR " ANSI_RESET "total:").u32(snap->total_threads_seen)
+		.str(" shown:").u32(snap->rows_count)
+		.str(" min_free_stack:").u32(static_cast<uint32_t>(snap->min_free_stack))
+		.str("B unknown_stack:").u32(snap->unknown_stack).str("\x1b[K");
+	emit(line);
  
 	cursor_to(kRowCyc, 1);
+	line.clear();
 	if (snap->total_cycles_ok) {
-		printk(ANSI_CYAN "CYC " ANSI_RESET "total_non_idle:%llu idle:%llu",
-		       (unsigned long long)snap->total_rt.total_cycles,
-		       (unsigned long long)snap->total_rt.idle_cycles);
+		line.str(ANSI_CYAN "CYC " ANSI_RESET "total_non_idle:").u64(snap->total_rt.total_cycles)
+			.str(" idle:").u64(snap->total_rt.idle_cycles);
 	} else {
-		printk(ANSI_CYAN "CYC " ANSI_RESET "n/a");
+		line.str(ANSI_CYAN "CYC " ANSI_RESET "n/a");
+	}
+	line.str("\x1b[K");
+	emit(line);
+ 
+	cursor_to(kRowLog, 1);
+	line.clear();
+	line.str((snap->log.dropped > 0U) ? ANSI_RED : ANSI_CYAN).str("LOG " ANSI_RESET "processed:")
+		.u32(snap->log.processed).str(" dropped:").u32(snap->log.dropped);
+	if (snap->log.buf_ok) {
+		line.str(" buf:").u32(snap->log.buf_used).ch('/').u32(snap->log.buf_size)
+			.str("B peak:").u32(snap->log.buf_peak).ch('B');
 	}
-	printk("\x1b[K");
+	line.str("\x1b[K");
+	emit(line);
  
 	cursor_to(kRowHeader, 1);
-	printk("%-12s %-5s %-8s %-10s %-6s", "thread", "prio", "stack(B)", "delta", "load%");
-	printk("\x1b[K");
+	line.clear();
+	header_row(line);
+	line.str("\x1b[K");
+	emit(line);
  
 	for (uint32_t i = 0; i < top_n; ++i) {
 		uint32_t pct = (snap->delta_sum > 0U)
@@ -132,17 +183,15 @@ void render_top_snapshot(const TopSnapshot *snap)
 			: 0U;
 		const char *name = (snap->rows[i].name != nullptr) ? snap->rows[i].name : "(noname)";
 		cursor_to(kRowThreadsStart + i, 1);
-		printk("%-12s %-5d %-8u %-10llu %-6u",
-		       name,
-		       snap->rows[i].prio,
-		       snap->rows[i].stack_free,
-		       (unsigned long long)snap->rows[i].delta_cycles,
-		       pct);
-		printk("\x1b[K");
+		line.clear();
+		line.str(name, 12).ch(' ').i32(snap->rows[i].prio, 5).ch(' ')
+			.u32(static_cast<uint32_t>(snap->rows[i].stack_free), 8).ch(' ')
+			.u64(snap->rows[i].delta_cycles, 10).ch(' ').u32(pct, 6).str("\x1b[K");
+		emit(line);
 	}
 	for (uint32_t i = top_n; i < kTopVisibleThreads; ++i) {
 		cursor_to(kRowThreadsStart + i, 1);
 		printk("\x1b[K");
 	}
 }
-} // namespace monitor
\ No newline at end of file
+} // namespace monitor
@@ -1,9 +1,13 @@
 #include "oled_demo.hpp"
 #include <zephyr/device.h>
 #include <zephyr/drivers/display.h>
+#include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/shell/shell.h>
 #include <zephyr/sys/util.h>
+#if defined(__ARM_FEATURE_DSP)
+#include <cmsis_core.h>
+#endif
 #include <errno.h>
 #include <cstdint>
 #include <stdlib.h>
@@ -17,11 +21,35 @@ LOG_MODULE_REGISTER(oled_demo, LOG_LEVEL_INF);
 /* Service override for this panel revision. */
 #define OLED_COLOR_ORDER OLED_COLOR_ORDER_BRG
  
+/* Frames are rendered in horizontal strips into two small ping-pong buffers:
+ * while oled_tx sends one strip with a windowed display_write(), the next
+ * one is computed into the other. 2 x 128 x 8 pixels is 4 KB instead of a
+ * 32 KB full-screen framebuffer.
+ */
+#define OLED_MAX_WIDTH 128
+#define OLED_STRIP_LINES 8
+#define OLED_TX_STACK_SIZE 1024
+#define OLED_TX_PRIO 5
+#define OLED_KBENCH_FRAMES 50
+#define OLED_KEEPALIVE_MS_DEFAULT 5000
+ 
+struct oled_strip {
+	uint16_t y;
+	uint16_t lines;
+	uint8_t buf;
+};
+ 
 static const struct device *display_dev = DEVICE_DT_GET(DT_CHOSEN(zephyr_display));
 static struct display_capabilities display_caps;
 static bool oled_ready;
-static uint16_t framebuf[128 * 128];
+static uint16_t strip_buf[2][OLED_MAX_WIDTH * OLED_STRIP_LINES];
+static struct k_sem strip_free[2];
+K_MSGQ_DEFINE(strip_q, sizeof(struct oled_strip), 2, 4);
+K_THREAD_STACK_DEFINE(oled_tx_stack, OLED_TX_STACK_SIZE);
+static struct k_thread oled_tx_thread;
 static uint8_t oled_brightness = 255;
+static uint32_t frame_cyc_last;
+static uint32_t frame_cyc_max;
  
 enum oled_test_mode {
 	OLED_TEST_ANIM = 0,
@@ -35,6 +63,27 @@ enum oled_test_mode {
  
 static enum oled_test_mode test_mode = OLED_TEST_ANIM;
  
+/* Static frames: every change of what the solid modes show bumps
+ * content_version. A frame whose version is already on the panel is
+ * neither rendered nor sent, except for a keep-alive re-send every
+ * keepalive_ms (0 = never); a strip buffer that already holds the
+ * version's pixels is sent as is.
+ */
+static uint32_t content_version = 1;
+static uint32_t sent_version;
+static uint32_t buf_version[2];
+static int64_t last_sent_ms;
+static uint32_t keepalive_ms = OLED_KEEPALIVE_MS_DEFAULT;
+static uint32_t frames_sent;
+static uint32_t frames_skipped;
+static uint32_t frames_keepalive;
+ 
+static void set_mode(enum oled_test_mode mode)
+{
+	test_mode = mode;
+	++content_version;
+}
+ 
 static uint16_t rgb565(uint8_t r, uint8_t g, uint8_t b)
 {
 	#if OLED_COLOR_ORDER == OLED_COLOR_ORDER_RGB
@@ -47,16 +96,43 @@ static uint16_t rgb565(uint8_t r, uint8_t g, uint8_t b)
 	#endif
 }
  
+static void oled_tx(void *p1, void *p2, void *p3)
+{
+	struct oled_strip strip;
+	struct display_buffer_descriptor desc = {};
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+ 
+	while (true) {
+		(void)k_msgq_get(&strip_q, &strip, K_FOREVER);
+		desc.width = display_caps.x_resolution;
+		desc.height = strip.lines;
+		desc.pitch = display_caps.x_resolution;
+		desc.buf_size = desc.width * desc.height * sizeof(uint16_t);
+		desc.frame_incomplete = false;
+		(void)display_write(display_dev, 0, strip.y, &desc, strip_buf[strip.buf]);
+		k_sem_give(&strip_free[strip.buf]);
+	}
+}
+ 
 void oled_demo_init()
 {
+	/* The panel is deferred-init for disp_io; with the LVGL dashboard
+	 * replaced by this demo nothing else brings it up.
+	 */
 	if (!device_is_ready(display_dev)) {
-		LOG_WRN("OLED device is not ready");
-		return;
+		int rc = device_init(display_dev);
+ 
+		if ((rc != 0) && (rc != -EALREADY)) {
+			LOG_WRN("OLED device is not ready: %d", rc);
+			return;
+		}
 	}
  
 	display_get_capabilities(display_dev, &display_caps);
-	if ((display_caps.x_resolution * display_caps.y_resolution) > ARRAY_SIZE(framebuf)) {
-		LOG_WRN("OLED frame buffer is too small for %ux%u",
+	if (display_caps.x_resolution > OLED_MAX_WIDTH) {
+		LOG_WRN("OLED strip buffer is too small for %ux%u",
 			display_caps.x_resolution, display_caps.y_resolution);
 		return;
 	}
@@ -67,73 +143,192 @@ void oled_demo_init()
 	}
 	(void)display_set_contrast(display_dev, oled_brightness);
  
+	k_sem_init(&strip_free[0], 1, 1);
+	k_sem_init(&strip_free[1], 1, 1);
+	k_thread_create(&oled_tx_thread, oled_tx_stack, K_THREAD_STACK_SIZEOF(oled_tx_stack),
+			oled_tx, NULL, NULL, NULL, OLED_TX_PRIO, 0, K_NO_WAIT);
+	k_thread_name_set(&oled_tx_thread, "oled_tx");
+ 
 	oled_ready = true;
 	LOG_INF("RGB OLED initialized: %ux%u", display_caps.x_resolution, display_caps.y_resolution);
 }
  
+static uint16_t solid_color(enum oled_test_mode mode)
+{
+	switch (mode) {
+	case OLED_TEST_RED:
+		return rgb565(255, 0, 0);
+	case OLED_TEST_GREEN:
+		return rgb565(0, 255, 0);
+	case OLED_TEST_BLUE:
+		return rgb565(0, 0, 255);
+	case OLED_TEST_WHITE:
+		return rgb565(255, 255, 255);
+	default:
+		return rgb565(0, 0, 0);
+	}
+}
+ 
+/* Per-byte add without carries between lanes (UADD8 semantics). */
+static inline uint32_t add8(uint32_t a, uint32_t b)
+{
+#if defined(__ARM_FEATURE_DSP)
+	return __UADD8(a, b);
+#else
+	return ((a & 0x7F7F7F7FU) + (b & 0x7F7F7F7FU)) ^ ((a ^ b) & 0x80808080U);
+#endif
+}
+ 
+/* One animation row. The gradient is produced two pixels per 32-bit word:
+ * the four byte lanes hold r(x), r(x+1), b(x), b(x+1), step with one UADD8
+ * (wrapping per lane like the & 0xFF of the scalar code) and are masked and
+ * shifted into two B-R-G 565 pixels; g is constant along a row. The border
+ * and bar columns are then written as spans instead of tested per pixel.
+ */
+static void render_row(uint16_t *dst, uint16_t y, uint32_t tick, uint16_t bar_x)
+{
+	uint16_t width = display_caps.x_resolution;
+	uint16_t height = display_caps.y_resolution;
+	uint16_t white = rgb565(255, 255, 255);
+	uint16_t x = 0;
+ 
+	if ((y == 0U) || (y == (height - 1U))) {
+		for (; x < width; ++x) {
+			dst[x] = white;
+		}
+	} else {
+		uint8_t g = (uint8_t)((y * 2U + tick) & 0xFFU);
+#if OLED_COLOR_ORDER == OLED_COLOR_ORDER_BRG
+		uint32_t gg = ((g & 0xF8U) >> 3) * 0x00010001U;
+		uint32_t lanes = (tick & 0xFFU) | (((2U + tick) & 0xFFU) << 8) |
+				 (((y + tick * 3U) & 0xFFU) << 16) | (((1U + y + tick * 3U) & 0xFFU) << 24);
+		for (; (x + 1U) < width; x += 2U) {
+			uint32_t m = lanes & 0xF8F8FCFCU;
+			uint32_t pair = ((m & 0xFFU) << 3) | ((m & 0xFF00U) << 11) |
+					((m >> 8) & 0xFF00U) | (m & 0xFF000000U) | gg;
+ 
+			/* memcpy, not a uint32_t * cast: no aliasing or alignment
+			 * assumption on dst; it compiles to a single store.
+			 */
+			memcpy(&dst[x], &pair, sizeof(pair));
+			lanes = add8(lanes, 0x02020404U);
+		}
+#endif
+		/* Other channel orders, and an odd last column. */
+		for (; x < width; ++x) {
+			dst[x] = rgb565((uint8_t)((x * 2U + tick) & 0xFFU), g,
+					(uint8_t)(((x + y) + tick * 3U) & 0xFFU));
+		}
+		dst[0] = white;
+		dst[width - 1U] = white;
+	}
+ 
+	dst[bar_x] = rgb565(255, 64, 0);
+	dst[(bar_x + 1U) % width] = rgb565(255, 64, 0);
+}
+ 
+/* Per-pixel reference for the row kernel, used by 'oledtest kbench'. */
+static void render_strip_ref(uint16_t *dst, uint16_t y0, uint16_t lines, uint32_t tick)
+{
+	uint16_t width = display_caps.x_resolution;
+	uint16_t height = display_caps.y_resolution;
+	uint16_t bar_x = (uint16_t)(tick % width);
+ 
+	for (uint16_t y = y0; y < (y0 + lines); ++y) {
+		for (uint16_t x = 0; x < width; ++x) {
+			size_t idx = x + ((size_t)(y - y0) * width);
+			bool border = (x == 0U) || (x == (width - 1U)) || (y == 0U) || (y == (height - 1U));
+			bool bar = (x == bar_x) || (x == ((bar_x + 1U) % width));
+			uint8_t r = (uint8_t)((x * 2U + tick) & 0xFFU);
+			uint8_t g = (uint8_t)((y * 2U + tick) & 0xFFU);
+			uint8_t b = (uint8_t)(((x + y) + tick * 3U) & 0xFFU);
+			uint16_t color = rgb565(r, g, b);
+			if (border) {
+				color = rgb565(255, 255, 255);
+			}
+			if (bar) {
+				color = rgb565(255, 64, 0);
+			}
+			dst[idx] = color;
+		}
+	}
+}
+ 
+static void render_strip(uint16_t *dst, uint16_t y0, uint16_t lines, uint32_t tick)
+{
+	uint16_t width = display_caps.x_resolution;
+ 
+	if (test_mode != OLED_TEST_ANIM) {
+		uint16_t color = solid_color(test_mode);
+ 
+		for (size_t i = 0; i < (size_t)width * lines; ++i) {
+			dst[i] = color;
+		}
+		return;
+	}
+ 
+	for (uint16_t y = 0; y < lines; ++y) {
+		render_row(&dst[(size_t)y * width], (uint16_t)(y0 + y), tick, (uint16_t)(tick % width));
+	}
+}
+ 
 void oled_demo_tick(uint32_t tick)
 {
-	struct display_buffer_descriptor desc = {};
-	uint16_t width;
 	uint16_t height;
-	uint16_t bar_x;
+	uint32_t start;
+	uint32_t n = 0;
  
 	if (!oled_ready) {
 		return;
 	}
  
-	width = display_caps.x_resolution;
-	height = display_caps.y_resolution;
-	bar_x = (uint16_t)(tick % width);
- 
 	if (test_mode == OLED_TEST_OFF) {
 		return;
 	}
  
-	if (test_mode != OLED_TEST_ANIM) {
-		uint16_t color = rgb565(0, 0, 0);
-		if (test_mode == OLED_TEST_RED) {
-			color = rgb565(255, 0, 0);
-		} else if (test_mode == OLED_TEST_GREEN) {
-			color = rgb565(0, 255, 0);
-		} else if (test_mode == OLED_TEST_BLUE) {
-			color = rgb565(0, 0, 255);
-		} else if (test_mode == OLED_TEST_WHITE) {
-			color = rgb565(255, 255, 255);
-		}
-		for (size_t i = 0; i < ARRAY_SIZE(framebuf); ++i) {
-			framebuf[i] = color;
+	/* The animation changes every tick; solid frames only on a new version. */
+	bool is_static = (test_mode != OLED_TEST_ANIM);
+	uint32_t version = content_version;
+	int64_t now = k_uptime_get();
+ 
+	if (is_static && (version == sent_version)) {
+		if ((keepalive_ms == 0U) || ((now - last_sent_ms) < keepalive_ms)) {
+			++frames_skipped;
+			return;
 		}
-	} else {
-		memset(framebuf, 0, sizeof(framebuf));
- 
-		for (uint16_t y = 0; y < height; ++y) {
-			for (uint16_t x = 0; x < width; ++x) {
-				size_t idx = x + ((size_t)y * width);
-				bool border = (x == 0U) || (x == (width - 1U)) || (y == 0U) || (y == (height - 1U));
-				bool bar = (x == bar_x) || (x == ((bar_x + 1U) % width));
-				uint8_t r = (uint8_t)((x * 2U + tick) & 0xFFU);
-				uint8_t g = (uint8_t)((y * 2U + tick) & 0xFFU);
-				uint8_t b = (uint8_t)(((x + y) + tick * 3U) & 0xFFU);
-				uint16_t color = rgb565(r, g, b);
-				if (border) {
-					color = rgb565(255, 255, 255);
-				}
-				if (bar) {
-					color = rgb565(255, 64, 0);
-				}
-				framebuf[idx] = color;
-			}
+		++frames_keepalive;
+	}
+ 
+	height = display_caps.y_resolution;
+	start = k_cycle_get_32();
+ 
+	for (uint16_t y0 = 0; y0 < height; y0 += OLED_STRIP_LINES, ++n) {
+		struct oled_strip strip;
+ 
+		strip.y = y0;
+		strip.lines = (uint16_t)MIN(OLED_STRIP_LINES, height - y0);
+		strip.buf = (uint8_t)(n & 1U);
+		(void)k_sem_take(&strip_free[strip.buf], K_FOREVER);
+		/* Solid strips are identical: fill each buffer once per version. */
+		if (!is_static || (buf_version[strip.buf] != version)) {
+			render_strip(strip_buf[strip.buf], strip.y,
+				     is_static ? OLED_STRIP_LINES : strip.lines, tick);
+			buf_version[strip.buf] = is_static ? version : 0U;
 		}
+		(void)k_msgq_put(&strip_q, &strip, K_FOREVER);
 	}
  
-	desc.buf_size = width * height * sizeof(uint16_t);
-	desc.width = width;
-	desc.height = height;
-	desc.pitch = width;
-	desc.frame_incomplete = false;
+	/* The frame is on the panel once both buffers are back. */
+	for (size_t i = 0; i < ARRAY_SIZE(strip_free); ++i) {
+		(void)k_sem_take(&strip_free[i], K_FOREVER);
+		k_sem_give(&strip_free[i]);
+	}
  
-	(void)display_write(display_dev, 0, 0, &desc, framebuf);
+	frame_cyc_last = k_cycle_get_32() - start;
+	frame_cyc_max = MAX(frame_cyc_max, frame_cyc_last);
+	sent_version = is_static ? version : 0U;
+	last_sent_ms = now;
+	++frames_sent;
 }
  
 static int cmd_oled_status(const struct shell *sh, size_t argc, char **argv)
@@ -144,6 +339,11 @@ static int cmd_oled_status(const struct shell *sh, size_t argc, char **argv)
 		    oled_ready ? 1 : 0, (int)test_mode,
 		    oled_brightness,
 		    display_caps.x_resolution, display_caps.y_resolution);
+	shell_print(sh, "frame=%u us (max %u us) strips=%u lines x2, %u B",
+		    k_cyc_to_us_floor32(frame_cyc_last), k_cyc_to_us_floor32(frame_cyc_max),
+		    OLED_STRIP_LINES, (unsigned int)sizeof(strip_buf));
+	shell_print(sh, "frames sent=%u skipped=%u (unchanged) keepalive=%u every %u ms",
+		    frames_sent, frames_skipped, frames_keepalive, keepalive_ms);
 	return 0;
 }
  
@@ -151,7 +351,7 @@ static int cmd_oled_anim(const struct shell *sh, size_t argc, char **argv)
 {
 	ARG_UNUSED(argc);
 	ARG_UNUSED(argv);
-	test_mode = OLED_TEST_ANIM;
+	set_mode(OLED_TEST_ANIM);
 	shell_print(sh, "OLED mode: animation");
 	return 0;
 }
@@ -160,7 +360,7 @@ static int cmd_oled_off(const struct shell *sh, size_t argc, char **argv)
 {
 	ARG_UNUSED(argc);
 	ARG_UNUSED(argv);
-	test_mode = OLED_TEST_OFF;
+	set_mode(OLED_TEST_OFF);
 	shell_print(sh, "OLED mode: off");
 	return 0;
 }
@@ -168,25 +368,25 @@ static int cmd_oled_off(const struct shell *sh, size_t argc, char **argv)
 static int cmd_oled_solid(const struct shell *sh, size_t argc, char **argv)
 {
 	if (argc != 2) {
-		shell_error(sh, "Usage: oled solid <r|g|b|w|k>");
+		shell_error(sh, "Usage: oledtest solid <r|g|b|w|k>");
 		return -EINVAL;
 	}
  
 	switch (argv[1][0]) {
 	case 'r':
-		test_mode = OLED_TEST_RED;
+		set_mode(OLED_TEST_RED);
 		break;
 	case 'g':
-		test_mode = OLED_TEST_GREEN;
+		set_mode(OLED_TEST_GREEN);
 		break;
 	case 'b':
-		test_mode = OLED_TEST_BLUE;
+		set_mode(OLED_TEST_BLUE);
 		break;
 	case 'w':
-		test_mode = OLED_TEST_WHITE;
+		set_mode(OLED_TEST_WHITE);
 		break;
 	case 'k':
-		test_mode = OLED_TEST_BLACK;
+		set_mode(OLED_TEST_BLACK);
 		break;
 	default:
 		shell_error(sh, "Unknown color");
@@ -203,7 +403,7 @@ static int cmd_oled_brightness(const struct shell *sh, size_t argc, char **argv)
 	long val;
  
 	if (argc != 2) {
-		shell_error(sh, "Usage: oled brightness <0..255>");
+		shell_error(sh, "Usage: oledtest brightness <0..255>");
 		return -EINVAL;
 	}
  
@@ -221,12 +421,91 @@ static int cmd_oled_brightness(const struct shell *sh, size_t argc, char **argv)
 	return 0;
 }
  
-SHELL_STATIC_SUBCMD_SET_CREATE(sub_oled,
+/* Render cost of the animation alone: OLED_KBENCH_FRAMES full frames with
+ * the row kernel and with the per-pixel reference, in the strip buffers
+ * (held for the duration, so nothing is sent).
+ */
+static int cmd_oled_kbench(const struct shell *sh, size_t argc, char **argv)
+{
+	static uint16_t ref[OLED_MAX_WIDTH * OLED_STRIP_LINES];
+	uint16_t height = display_caps.y_resolution;
+	uint32_t kernel_cyc = 0;
+	uint32_t ref_cyc = 0;
+	uint32_t mismatches = 0;
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+ 
+	if (!oled_ready) {
+		shell_error(sh, "OLED is not ready");
+		return -ENODEV;
+	}
+ 
+	enum oled_test_mode saved = test_mode;
+ 
+	(void)k_sem_take(&strip_free[0], K_FOREVER);
+	(void)k_sem_take(&strip_free[1], K_FOREVER);
+	test_mode = OLED_TEST_ANIM;
+ 
+	for (uint32_t tick = 0; tick < OLED_KBENCH_FRAMES; ++tick) {
+		for (uint16_t y0 = 0; y0 < height; y0 += OLED_STRIP_LINES) {
+			uint16_t lines = (uint16_t)MIN(OLED_STRIP_LINES, height - y0);
+			uint32_t start = k_cycle_get_32();
+ 
+			render_strip(strip_buf[0], y0, lines, tick);
+			kernel_cyc += k_cycle_get_32() - start;
+			start = k_cycle_get_32();
+			render_strip_ref(ref, y0, lines, tick);
+			ref_cyc += k_cycle_get_32() - start;
+			if (memcmp(ref, strip_buf[0], (size_t)lines * display_caps.x_resolution * 2U) != 0) {
+				++mismatches;
+			}
+		}
+	}
+ 
+	test_mode = saved;
+	buf_version[0] = 0U;
+	k_sem_give(&strip_free[1]);
+	k_sem_give(&strip_free[0]);
+ 
+	shell_print(sh, "%s kernel: %u cycles/frame, per-pixel: %u cycles/frame, mismatched strips: %u",
+#if defined(__ARM_FEATURE_DSP)
+		    "UADD8",
+#else
+		    "portable",
+#endif
+		    kernel_cyc / OLED_KBENCH_FRAMES, ref_cyc / OLED_KBENCH_FRAMES, mismatches);
+	return (mismatches == 0U) ? 0 : -EIO;
+}
+ 
+static int cmd_oled_keepalive(const struct shell *sh, size_t argc, char **argv)
+{
+	char *end = NULL;
+	unsigned long val;
+ 
+	if (argc != 2) {
+		shell_error(sh, "Usage: oledtest keepalive <ms, 0=off>");
+		return -EINVAL;
+	}
+ 
+	val = strtoul(argv[1], &end, 10);
+	if ((end == argv[1]) || (*end != '\0') || (val > 600000UL)) {
+		shell_error(sh, "Keep-alive must be 0..600000 ms");
+		return -EINVAL;
+	}
+ 
+	keepalive_ms = (uint32_t)val;
+	shell_print(sh, "OLED keep-alive: %u ms", keepalive_ms);
+	return 0;
+}
+ 
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_oledtest,
 	SHELL_CMD(status, NULL, "OLED status", cmd_oled_status),
 	SHELL_CMD(anim, NULL, "OLED animation test", cmd_oled_anim),
 	SHELL_CMD(off, NULL, "OLED off", cmd_oled_off),
 	SHELL_CMD(brightness, NULL, "OLED brightness 0..255", cmd_oled_brightness),
 	SHELL_CMD(solid, NULL, "OLED solid color (r|g|b|w|k)", cmd_oled_solid),
+	SHELL_CMD(keepalive, NULL, "Re-send static frames every <ms> (0=off)", cmd_oled_keepalive),
+	SHELL_CMD(kbench, NULL, "Animation render cycles per frame", cmd_oled_kbench),
 	SHELL_SUBCMD_SET_END
 );
-SHELL_CMD_REGISTER(oled, &sub_oled, "OLED test commands", NULL);
\ No newline at end of file
+SHELL_CMD_REGISTER(oledtest, &sub_oledtest, "OLED test patterns (CONFIG_APP_OLED_DEMO)", NULL);
\ No newline at end of file
@@ -0,0 +1,238 @@
+#include "fpu_demo.hpp"
+#include "monitor/flush_stats.hpp"
+#if defined(CONFIG_APP_FONT_BENCH)
+#include "display/font_subset.h"
+#endif
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <lvgl.h>
+#include <lvgl_zephyr.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <cstdint>
+#if defined(CONFIG_CPU_CORTEX_M7)
+#include <cmsis_core.h>
+#endif
+ 
+#define PERF_DEFAULT_FRAMES 50
+#define PERF_MAX_FRAMES 1000
+#define PERF_FONT_ROUNDS 100
+#define PERF_FPU_BATCHES 20
+#define PERF_STYLE_ROUNDS 200
+ 
+/* Cache-sensitive benchmarks: full-screen LVGL render time and fpu_worker
+ * batch time. Run once with CONFIG_DCACHE=n and once with =y to compare.
+ */
+static const char *dcache_state()
+{
+#if defined(CONFIG_CPU_CORTEX_M7)
+	return ((SCB->CCR & SCB_CCR_DC_Msk) != 0U) ? "on" : "off";
+#else
+	return "n/a";
+#endif
+}
+ 
+static uint32_t cyc_to_us(uint64_t cycles)
+{
+	return static_cast<uint32_t>(k_cyc_to_us_floor64(cycles));
+}
+ 
+static int cmd_perf_render(const struct shell *sh, size_t argc, char **argv)
+{
+	monitor::FlushStats before;
+	monitor::FlushStats after;
+	uint32_t frames = PERF_DEFAULT_FRAMES;
+	char *end = nullptr;
+ 
+	if (argc > 2) {
+		shell_error(sh, "Usage: perf render [frames]");
+		return -EINVAL;
+	}
+	if (argc == 2) {
+		unsigned long val = strtoul(argv[1], &end, 10);
+ 
+		if ((end == argv[1]) || (*end != '\0') || (val == 0UL) || (val > PERF_MAX_FRAMES)) {
+			shell_error(sh, "frames must be 1..%d", PERF_MAX_FRAMES);
+			return -EINVAL;
+		}
+		frames = static_cast<uint32_t>(val);
+	}
+ 
+	monitor::flush_stats_get(&before);
+	uint32_t start = k_cycle_get_32();
+ 
+	for (uint32_t i = 0; i < frames; ++i) {
+		lvgl_lock();
+		lv_obj_invalidate(lv_screen_active());
+		lv_refr_now(nullptr);
+		lvgl_unlock();
+	}
+ 
+	uint32_t spent = k_cycle_get_32() - start;
+ 
+	monitor::flush_stats_get(&after);
+	uint32_t done = after.frames - before.frames;
+	uint64_t render = after.render_cyc - before.render_cyc;
+ 
+	shell_print(sh, "dcache=%s frames=%u wall=%u us/frame render=%u us/frame", dcache_state(),
+		    done, cyc_to_us(spent) / frames, (done > 0U) ? cyc_to_us(render / done) : 0U);
+	return 0;
+}
+ 
+/* Times PERF_FPU_BATCHES batches on the shell thread, so it works whether or
+ * not the fpu_worker threads are running; their own figures are added when
+ * they are.
+ */
+static int cmd_perf_fpu(const struct shell *sh, size_t argc, char **argv)
+{
+	FpuBatchStats st;
+	uint32_t min_cyc = UINT32_MAX;
+	uint32_t last_cyc = 0;
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+ 
+	for (int i = 0; i < PERF_FPU_BATCHES; ++i) {
+		last_cyc = fpu_demo_run_batch();
+		min_cyc = MIN(min_cyc, last_cyc);
+	}
+ 
+	uint32_t min_us = MAX(cyc_to_us(min_cyc), 1U);
+ 
+	shell_print(sh, "dcache=%s batches=%d batch min=%u us last=%u us (%u iter/ms)", dcache_state(),
+		    PERF_FPU_BATCHES, min_us, cyc_to_us(last_cyc),
+		    (fpu_demo_iterations_per_batch() * 1000U) / min_us);
+ 
+	fpu_demo_get_stats(&st);
+	if (st.batches > 0U) {
+		shell_print(sh, "workers: batches=%u batch min=%u us last=%u us", st.batches,
+			    MAX(cyc_to_us(st.min_cyc), 1U), cyc_to_us(st.last_cyc));
+	}
+	return 0;
+}
+ 
+#if defined(CONFIG_APP_FONT_BENCH)
+/* Decodes every glyph of the subset PERF_FONT_ROUNDS times per variant:
+ * descriptor lookup plus bitmap expansion to A8, which is what the label
+ * renderer pays per character (RLE variants decompress here).
+ */
+static int cmd_perf_font(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+ 
+	shell_print(sh, "dcache=%s glyphs=\"%s\" rounds=%d", dcache_state(), app_font_glyphs,
+		    PERF_FONT_ROUNDS);
+ 
+	lvgl_lock();
+	for (size_t v = 0; v < app_font_variant_count; ++v) {
+		const struct app_font_variant *var = &app_font_variants[v];
+		int32_t side = 2 * lv_font_get_line_height(var->font);
+		lv_draw_buf_t *buf = lv_draw_buf_create(side, side, LV_COLOR_FORMAT_A8, LV_STRIDE_AUTO);
+ 
+		if (buf == nullptr) {
+			lvgl_unlock();
+			shell_error(sh, "no memory for a %dx%d glyph buffer", side, side);
+			return -ENOMEM;
+		}
+ 
+		uint32_t decoded = 0;
+		uint32_t start = k_cycle_get_32();
+ 
+		for (int round = 0; round < PERF_FONT_ROUNDS; ++round) {
+			for (const char *p = app_font_glyphs; *p != '\0'; ++p) {
+				lv_font_glyph_dsc_t g;
+ 
+				if (static_cast<uint8_t>(*p) >= 0x80U) {
+					continue; /* UTF-8 tail bytes: ASCII glyphs are enough here */
+				}
+				if (lv_font_get_glyph_dsc(var->font, &g, static_cast<uint8_t>(*p), 0) &&
+				    (lv_font_get_glyph_bitmap(&g, buf) != nullptr)) {
+					++decoded;
+				}
+			}
+		}
+ 
+		uint32_t spent = k_cycle_get_32() - start;
+ 
+		lv_draw_buf_destroy(buf);
+		shell_print(sh, "%-9s bitmap=%u B decode=%u ns/glyph", var->name,
+			    static_cast<unsigned int>(var->bitmap_bytes),
+			    (decoded > 0U) ? static_cast<uint32_t>(k_cyc_to_ns_floor64(spent) / decoded)
+					   : 0U);
+	}
+	lvgl_unlock();
+	return 0;
+}
+#endif
+ 
+/* Props the draw path resolves for arcs, labels and images. */
+static const lv_style_prop_t kStyleProps[] = {
+	LV_STYLE_BG_COLOR, LV_STYLE_BG_OPA, LV_STYLE_BG_IMAGE_RECOLOR,
+	LV_STYLE_BG_IMAGE_RECOLOR_OPA, LV_STYLE_ARC_COLOR, LV_STYLE_ARC_OPA,
+	LV_STYLE_ARC_WIDTH, LV_STYLE_TEXT_COLOR, LV_STYLE_TEXT_FONT,
+	LV_STYLE_BORDER_WIDTH, LV_STYLE_PAD_TOP, LV_STYLE_RADIUS,
+};
+static const lv_part_t kStyleParts[] = {LV_PART_MAIN, LV_PART_INDICATOR, LV_PART_KNOB};
+ 
+static uint32_t style_walk(lv_obj_t *obj, uint32_t *objs)
+{
+	uint32_t lookups = 0;
+ 
+	*objs += 1U;
+	for (lv_part_t part : kStyleParts) {
+		for (lv_style_prop_t prop : kStyleProps) {
+			(void)lv_obj_get_style_prop(obj, part, prop);
+			++lookups;
+		}
+	}
+	for (uint32_t i = 0; i < lv_obj_get_child_count(obj); ++i) {
+		lookups += style_walk(lv_obj_get_child(obj, static_cast<int32_t>(i)), objs);
+	}
+	return lookups;
+}
+ 
+/* Resolves the draw-relevant style props of every object on the active
+ * screen, roughly the lookups one full redraw does. Run with
+ * CONFIG_APP_UI_CONST_STYLES=y and =n to compare local and const styles.
+ */
+static int cmd_perf_styles(const struct shell *sh, size_t argc, char **argv)
+{
+	uint32_t objs = 0;
+	uint32_t lookups = 0;
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+ 
+	lvgl_lock();
+	uint32_t start = k_cycle_get_32();
+ 
+	for (int round = 0; round < PERF_STYLE_ROUNDS; ++round) {
+		objs = 0;
+		lookups = style_walk(lv_screen_active(), &objs);
+	}
+ 
+	uint32_t spent = k_cycle_get_32() - start;
+ 
+	lvgl_unlock();
+ 
+	uint64_t pass_ns = k_cyc_to_ns_floor64(spent) / PERF_STYLE_ROUNDS;
+ 
+	shell_print(sh, "dcache=%s const_styles=%s objs=%u", dcache_state(),
+		    IS_ENABLED(CONFIG_APP_UI_CONST_STYLES) ? "y" : "n", objs);
+	shell_print(sh, "lookups/pass=%u pass=%u us (%u ns/lookup)", lookups,
+		    static_cast<uint32_t>(pass_ns / 1000U),
+		    (lookups > 0U) ? static_cast<uint32_t>(pass_ns / lookups) : 0U);
+	return 0;
+}
+ 
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_perf,
+	SHELL_CMD(render, NULL, "Full-screen LVGL redraws: render [frames]", cmd_perf_render),
+	SHELL_CMD(fpu, NULL, "fpu_worker batch time (timed here)", cmd_perf_fpu),
+#if defined(CONFIG_APP_FONT_BENCH)
+	SHELL_CMD(font, NULL, "Subset font variants: flash size vs glyph decode time",
+		  cmd_perf_font),
+#endif
+	SHELL_CMD(styles, NULL, "Style lookups over the active screen, ns per lookup",
+		  cmd_perf_styles),
+	SHELL_SUBCMD_SET_END
+);
+SHELL_CMD_REGISTER(perf, &sub_perf, "Cache-sensitive benchmarks", NULL);
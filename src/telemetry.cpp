@@ -0,0 +1,325 @@
+#include "telemetry.hpp"
+#include "lvgl_demo.hpp"
+#include "monitor/top_collector.hpp"
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/sys/byteorder.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cstdint>
+ 
+#define TELEM_STACK_SIZE 2048
+#define TELEM_PRIO 10
+#define TELEM_MAX_RATE_HZ 100
+ 
+LOG_MODULE_REGISTER(telemetry, LOG_LEVEL_INF);
+ 
+/* Wire format v1, little-endian, no padding. Decoded by scripts/telemetry_rx.py. */
+namespace {
+constexpr uint16_t kMagic = 0x4D54; /* "TM" */
+constexpr uint8_t kVersion = 1;
+constexpr uint32_t kMaxThreads = 8;
+ 
+struct __packed PacketHeader {
+	uint16_t magic;
+	uint8_t version;
+	uint8_t thread_count;
+	uint32_t seq;
+	uint32_t uptime_ms;
+	uint16_t load_permille;
+	uint16_t fps;
+	uint32_t heap_used;
+	uint32_t heap_free;
+	uint32_t heap_peak;
+	uint32_t min_stack;
+	uint32_t log_dropped;
+};
+ 
+struct __packed ThreadEntry {
+	char name[8];
+	int8_t prio;
+	uint8_t reserved;
+	uint16_t load_permille;
+	uint16_t stack_free;
+};
+} // namespace
+ 
+K_THREAD_STACK_DEFINE(telem_stack, TELEM_STACK_SIZE);
+static struct k_thread telem_thread;
+static K_TIMER_DEFINE(telem_timer, NULL, NULL);
+static bool telem_started;
+static atomic_t telem_stop_req;
+static uint32_t telem_rate_hz = CONFIG_APP_TELEMETRY_RATE_HZ;
+static struct sockaddr_in telem_peer;
+static uint32_t telem_seq;
+static uint32_t telem_sent;
+static uint32_t telem_errors;
+static int telem_last_err;
+ 
+/* The datagram is serialized in place into this buffer and handed to the
+ * stack as is: no intermediate structs, no heap, one copy inside the stack.
+ */
+static uint8_t tx_buf[sizeof(PacketHeader) + kMaxThreads * sizeof(ThreadEntry)];
+static monitor::TopSnapshot telem_snap;
+static monitor::CycleTracker telem_tracker;
+ 
+static size_t pack_snapshot(const monitor::TopSnapshot *snap)
+{
+	auto *hdr = reinterpret_cast<PacketHeader *>(tx_buf);
+	auto *entries = reinterpret_cast<ThreadEntry *>(tx_buf + sizeof(PacketHeader));
+	uint32_t count = MIN(snap->rows_count, kMaxThreads);
+ 
+	hdr->magic = sys_cpu_to_le16(kMagic);
+	hdr->version = kVersion;
+	hdr->thread_count = static_cast<uint8_t>(count);
+	hdr->seq = sys_cpu_to_le32(telem_seq++);
+	hdr->uptime_ms = sys_cpu_to_le32(k_uptime_get_32());
+	hdr->load_permille = sys_cpu_to_le16(static_cast<uint16_t>(snap->load_permille));
+	hdr->fps = sys_cpu_to_le16(LvglDemo::instance().fps());
+	hdr->heap_used = sys_cpu_to_le32(snap->heap_ok ? snap->heap_stats.allocated_bytes : 0U);
+	hdr->heap_free = sys_cpu_to_le32(snap->heap_ok ? snap->heap_stats.free_bytes : 0U);
+	hdr->heap_peak = sys_cpu_to_le32(snap->heap_ok ? snap->heap_stats.max_allocated_bytes : 0U);
+	hdr->min_stack = sys_cpu_to_le32(snap->min_free_stack);
+	hdr->log_dropped = sys_cpu_to_le32(snap->log.dropped);
+ 
+	for (uint32_t i = 0; i < count; ++i) {
+		const monitor::ThreadRow *row = &snap->rows[i];
+		uint32_t permille = (snap->delta_sum > 0U)
+			? static_cast<uint32_t>((row->delta_cycles * 1000U) / snap->delta_sum)
+			: 0U;
+ 
+		memset(entries[i].name, 0, sizeof(entries[i].name));
+		if (row->name != nullptr) {
+			memcpy(entries[i].name, row->name, strnlen(row->name, sizeof(entries[i].name)));
+		}
+		entries[i].prio = static_cast<int8_t>(CLAMP(row->prio, INT8_MIN, INT8_MAX));
+		entries[i].reserved = 0;
+		entries[i].load_permille = sys_cpu_to_le16(static_cast<uint16_t>(permille));
+		entries[i].stack_free = sys_cpu_to_le16(static_cast<uint16_t>(MIN(row->stack_free, 0xFFFFU)));
+	}
+ 
+	return sizeof(PacketHeader) + count * sizeof(ThreadEntry);
+}
+ 
+static void restart_timer()
+{
+	k_timeout_t period = K_USEC(USEC_PER_SEC / telem_rate_hz);
+ 
+	k_timer_start(&telem_timer, period, period);
+}
+ 
+/* p1 is the socket, opened by telemetry_start() and closed here on stop. */
+static void telem_worker(void *p1, void *p2, void *p3)
+{
+	int sock = static_cast<int>(reinterpret_cast<intptr_t>(p1));
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+ 
+	restart_timer();
+	while (atomic_get(&telem_stop_req) == 0) {
+		(void)k_timer_status_sync(&telem_timer);
+		if (atomic_get(&telem_stop_req) != 0) {
+			break;
+		}
+ 
+		monitor::collect_top_snapshot(&telem_snap, &telem_tracker);
+		size_t len = pack_snapshot(&telem_snap);
+ 
+		if (zsock_sendto(sock, tx_buf, len, 0, reinterpret_cast<struct sockaddr *>(&telem_peer),
+				 sizeof(telem_peer)) < 0) {
+			telem_errors++;
+			telem_last_err = errno;
+		} else {
+			telem_sent++;
+		}
+	}
+ 
+	(void)zsock_close(sock);
+}
+ 
+static bool set_peer(const char *addr, uint16_t port)
+{
+	struct sockaddr_in peer = {};
+ 
+	peer.sin_family = AF_INET;
+	peer.sin_port = htons(port);
+	if (zsock_inet_pton(AF_INET, addr, &peer.sin_addr) != 1) {
+		return false;
+	}
+	telem_peer = peer;
+	return true;
+}
+ 
+bool telemetry_is_running()
+{
+	return telem_started;
+}
+ 
+int telemetry_start()
+{
+	char addr[NET_IPV4_ADDR_LEN];
+ 
+	if (telem_started) {
+		return -EALREADY;
+	}
+	if ((telem_peer.sin_family != AF_INET) &&
+	    !set_peer(CONFIG_APP_TELEMETRY_PEER_ADDR, CONFIG_APP_TELEMETRY_PORT)) {
+		LOG_ERR("Invalid peer address %s", CONFIG_APP_TELEMETRY_PEER_ADDR);
+		return -EINVAL;
+	}
+ 
+	/* Opened here so a failure is reported to the caller instead of
+	 * leaving a started flag with no thread behind it.
+	 */
+	int sock = zsock_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+ 
+	if (sock < 0) {
+		telem_last_err = errno;
+		LOG_ERR("socket() failed: %d", telem_last_err);
+		return -telem_last_err;
+	}
+ 
+	atomic_clear(&telem_stop_req);
+	k_thread_create(&telem_thread, telem_stack, K_THREAD_STACK_SIZEOF(telem_stack), telem_worker,
+			reinterpret_cast<void *>(static_cast<intptr_t>(sock)), nullptr, nullptr,
+			TELEM_PRIO, 0, K_NO_WAIT);
+	k_thread_name_set(&telem_thread, "telemetry");
+	telem_started = true;
+	(void)zsock_inet_ntop(AF_INET, &telem_peer.sin_addr, addr, sizeof(addr));
+	LOG_INF("Telemetry to %s:%u at %u Hz", addr, ntohs(telem_peer.sin_port), telem_rate_hz);
+	return 0;
+}
+ 
+int telemetry_stop()
+{
+	if (!telem_started) {
+		return -EALREADY;
+	}
+ 
+	atomic_set(&telem_stop_req, 1);
+	k_timer_stop(&telem_timer);
+	(void)k_thread_join(&telem_thread, K_FOREVER);
+	telem_started = false;
+	return 0;
+}
+ 
+int telemetry_set_rate(uint32_t rate_hz)
+{
+	if ((rate_hz == 0U) || (rate_hz > TELEM_MAX_RATE_HZ)) {
+		return -EINVAL;
+	}
+ 
+	telem_rate_hz = rate_hz;
+	if (telem_started) {
+		restart_timer();
+	}
+	return 0;
+}
+ 
+static int cmd_telem_start(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+ 
+	int rc = telemetry_start();
+ 
+	if (rc == -EALREADY) {
+		shell_warn(sh, "telemetry already running");
+		return rc;
+	}
+	if (rc != 0) {
+		shell_error(sh, "telemetry start failed: %d", rc);
+		return rc;
+	}
+	shell_print(sh, "telemetry started");
+	return 0;
+}
+ 
+static int cmd_telem_stop(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+ 
+	if (telemetry_stop() != 0) {
+		shell_warn(sh, "telemetry is not running");
+		return -EALREADY;
+	}
+	shell_print(sh, "telemetry stopped");
+	return 0;
+}
+ 
+static int cmd_telem_rate(const struct shell *sh, size_t argc, char **argv)
+{
+	char *end = nullptr;
+	long val;
+ 
+	if (argc != 2) {
+		shell_error(sh, "Usage: telem rate <1..%d>", TELEM_MAX_RATE_HZ);
+		return -EINVAL;
+	}
+ 
+	val = strtol(argv[1], &end, 10);
+	if ((end == argv[1]) || (*end != '\0') ||
+	    (telemetry_set_rate(static_cast<uint32_t>(MAX(val, 0L))) != 0)) {
+		shell_error(sh, "Rate must be 1..%d Hz", TELEM_MAX_RATE_HZ);
+		return -EINVAL;
+	}
+	shell_print(sh, "telemetry rate: %u Hz", telem_rate_hz);
+	return 0;
+}
+ 
+static int cmd_telem_peer(const struct shell *sh, size_t argc, char **argv)
+{
+	long port = CONFIG_APP_TELEMETRY_PORT;
+	char *end = nullptr;
+ 
+	if ((argc < 2) || (argc > 3)) {
+		shell_error(sh, "Usage: telem peer <ipv4> [port]");
+		return -EINVAL;
+	}
+	if (argc == 3) {
+		port = strtol(argv[2], &end, 10);
+		if ((end == argv[2]) || (*end != '\0') || (port < 1) || (port > 65535)) {
+			shell_error(sh, "Port must be 1..65535");
+			return -EINVAL;
+		}
+	}
+	if (!set_peer(argv[1], static_cast<uint16_t>(port))) {
+		shell_error(sh, "Invalid IPv4 address");
+		return -EINVAL;
+	}
+	shell_print(sh, "telemetry peer: %s:%ld", argv[1], port);
+	return 0;
+}
+ 
+static int cmd_telem_status(const struct shell *sh, size_t argc, char **argv)
+{
+	char addr[NET_IPV4_ADDR_LEN];
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+ 
+	if (zsock_inet_ntop(AF_INET, &telem_peer.sin_addr, addr, sizeof(addr)) == nullptr) {
+		strcpy(addr, "-");
+	}
+	shell_print(sh, "telemetry: %s rate=%uHz peer=%s:%u", telem_started ? "running" : "stopped",
+		    telem_rate_hz, addr, ntohs(telem_peer.sin_port));
+	shell_print(sh, "sent=%u errors=%u last_err=%d size=%uB", telem_sent, telem_errors,
+		    telem_last_err,
+		    static_cast<unsigned int>(sizeof(PacketHeader) +
+					      MIN(telem_snap.rows_count, kMaxThreads) *
+						      sizeof(ThreadEntry)));
+	return 0;
+}
+ 
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_telem,
+	SHELL_CMD(start, NULL, "Start UDP telemetry", cmd_telem_start),
+	SHELL_CMD(stop, NULL, "Stop UDP telemetry", cmd_telem_stop),
+	SHELL_CMD(rate, NULL, "Set rate: rate <1..100>", cmd_telem_rate),
+	SHELL_CMD(peer, NULL, "Set receiver: peer <ipv4> [port]", cmd_telem_peer),
+	SHELL_CMD(status, NULL, "Show telemetry status", cmd_telem_status),
+	SHELL_SUBCMD_SET_END
+);
+SHELL_CMD_REGISTER(telem, &sub_telem, "UDP telemetry commands", NULL);
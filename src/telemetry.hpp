@@ -0,0 +1,8 @@
+#pragma once
+ 
+#include <cstdint>
+ 
+int telemetry_start();
+int telemetry_stop();
+bool telemetry_is_running();
+int telemetry_set_rate(uint32_t rate_hz);
@@ -12,6 +12,7 @@
 K_THREAD_STACK_DEFINE(top_stack, TOP_STACK_SIZE);
 static struct k_thread top_thread;
 static bool top_started;
+static monitor::CycleTracker top_tracker;
  
 static void top_worker(void *p1, void *p2, void *p3)
 {
@@ -22,7 +23,7 @@ static void top_worker(void *p1, void *p2, void *p3)
  
 	monitor::draw_layout_once();
 	while (true) {
-		monitor::collect_top_snapshot(&snap);
+		monitor::collect_top_snapshot(&snap, &top_tracker);
 		monitor::render_top_snapshot(&snap);
 		k_sleep(K_SECONDS(1));
 	}
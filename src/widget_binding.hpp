@@ -0,0 +1,59 @@
+#pragma once
+/* Типизированная привязка значения к LVGL-виджету.
+ * Кэширует последнее отрисованное значение и вызывает LVGL (а значит,
+ * инвалидирует область экрана) только при реальном изменении.
+ *
+ * Наблюдатели LVGL (lv_subject_t) уведомляют подписчиков на каждый
+ * lv_subject_set_*, даже с тем же значением, поэтому кэш нужен в любом
+ * случае — здесь он без лишней прослойки.
+ */
+#include <cstdint>
+
+struct _lv_obj_t;
+
+template <typename T>
+class WidgetBinding {
+public:
+    /* Применяет значение к виджету (форматирование + вызов LVGL). */
+    using Apply = void (*)(struct _lv_obj_t *obj, T value);
+
+    explicit constexpr WidgetBinding(Apply apply) : apply_(apply) {}
+
+    /* Привязывает виджет; следующий set() отрисует значение безусловно. */
+    void bind(struct _lv_obj_t *obj)
+    {
+        obj_   = obj;
+        valid_ = false;
+    }
+
+    /* Вызывать под lvgl_lock. Возвращает true, если виджет обновлён. */
+    bool set(T value)
+    {
+        if (obj_ == nullptr) {
+            return false;
+        }
+        if (valid_ && (value == last_)) {
+            skipped_++;
+            return false;
+        }
+        last_  = value;
+        valid_ = true;
+        applied_++;
+        apply_(obj_, value);
+        return true;
+    }
+
+    /* Сбрасывает кэш: следующий set() перерисует виджет. */
+    void invalidate() { valid_ = false; }
+
+    uint32_t applied() const { return applied_; }
+    uint32_t skipped() const { return skipped_; }
+
+private:
+    Apply             apply_;
+    struct _lv_obj_t *obj_     {nullptr};
+    T                 last_    {};
+    bool              valid_   {false};
+    uint32_t          applied_ {0};
+    uint32_t          skipped_ {0};
+};
@@ -0,0 +1,56 @@
+#pragma once
+/* Неблокирующий почтовый ящик обновлений виджетов: по ячейке на виджет
+ * и битовая маска «есть новое значение».
+ *
+ * post() вызывается из любого потока (и из ISR): атомарная запись значения
+ * и атомарный OR бита — без мьютексов и без ожидания рендера. Несколько
+ * post() одного виджета до разбора схлопываются: побеждает последнее.
+ * drain() вызывается только в потоке LVGL и забирает все изменения разом
+ * (одна атомарная замена маски).
+ *
+ * Гонка post()/drain() безопасна: значение пишется до бита, а бит снимается
+ * до чтения значения, поэтому обновление не теряется — в худшем случае то же
+ * значение применится дважды (WidgetBinding отбросит повтор).
+ */
+#include <zephyr/sys/atomic.h>
+#include <cstddef>
+#include <cstdint>
+
+template <size_t N>
+class WidgetMailbox {
+    static_assert(N <= 32, "маска изменений — один atomic_t");
+
+public:
+    void post(uint32_t id, int32_t value)
+    {
+        (void)atomic_set(&values_[id], static_cast<atomic_val_t>(value));
+        (void)atomic_or(&dirty_, static_cast<atomic_val_t>(1UL << id));
+        (void)atomic_inc(&posted_);
+    }
+
+    /* Применяет apply(id, value) к каждому изменённому виджету.
+     * Возвращает число применённых обновлений. */
+    template <typename F>
+    uint32_t drain(F apply)
+    {
+        uint32_t dirty = static_cast<uint32_t>(atomic_clear(&dirty_));
+        uint32_t n = 0;
+        while (dirty != 0U) {
+            const uint32_t id = static_cast<uint32_t>(__builtin_ctz(dirty));
+            dirty &= dirty - 1U;
+            apply(id, static_cast<int32_t>(atomic_get(&values_[id])));
+            n++;
+        }
+        drained_ += n;
+        return n;
+    }
+
+    uint32_t posted() const { return static_cast<uint32_t>(atomic_get(&posted_)); }
+    uint32_t drained() const { return drained_; }
+
+private:
+    atomic_t values_[N] {};
+    atomic_t dirty_     {ATOMIC_INIT(0)};
+    atomic_t posted_    {ATOMIC_INIT(0)};
+    uint32_t drained_   {0};   /* только поток LVGL */
+};